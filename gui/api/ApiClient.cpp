@@ -18,6 +18,8 @@
 #include "api/ApiClient.hpp"
 #include "config/Config.hpp"
 
+#include <QCborValue>
+#include <QCborMap>
 #include <string>
 
 ApiClient* ApiClient::instance(){
@@ -31,7 +33,7 @@ ApiClient* ApiClient::instance(){
 ApiClient::ApiClient(QObject *parent)
     : QObject{parent}, socket(new QTcpSocket(this)){
     connect(socket, &QTcpSocket::readyRead, this, &ApiClient::onReadyRead);
-    connect(socket, &QTcpSocket::connected, this, &ApiClient::connected);
+    connect(socket, &QTcpSocket::connected, this, &ApiClient::onConnected);
     connect(socket, &QTcpSocket::disconnected, this, &ApiClient::disconnected);
     connect(socket, &QTcpSocket::errorOccurred, this, &ApiClient::onErrorOccurred);
 }
@@ -41,24 +43,66 @@ void ApiClient::connectToBackend(){
     QString serverAddress = QString::fromStdString(Config::get<std::string>("server.address").value()) ;
     int serverPort = Config::get<int>("server.port").value() ;
     qDebug() << "connecting to " << serverAddress << "port" << serverPort ;
+
+    // the backend speaks msgpack as well, but Qt only has a native CBOR codec
+    requestedFormat_ = WireFormat::JSON ;
+    std::string format = Config::get<std::string>("server.wire_format").value_or("json");
+    try {
+        requestedFormat_ = wireFormatFromString(format);
+    } catch (const std::exception& e){
+        qWarning() << "ignoring server.wire_format:" << e.what() ;
+    }
+    useSharedMemory_ = Config::get<bool>("server.shared_memory").value_or(false);
+
+    if ( requestedFormat_ == WireFormat::MSGPACK ){
+        qWarning() << "msgpack is not supported by the GUI, falling back to cbor" ;
+        requestedFormat_ = WireFormat::CBOR ;
+    }
     socket->connectToHost(serverAddress, serverPort );
 }
 
 void ApiClient::sendMessage(const QJsonObject &msg){
-    QJsonDocument doc(msg);
-    QByteArray data = doc.toJson(QJsonDocument::Compact) + "\n" ;
-    qInfo() << "Sending Message:" << data ;
+    QByteArray data ;
+    if ( sendFormat_ == WireFormat::CBOR ){
+        QByteArray payload = QCborValue::fromJsonValue(msg).toCbor();
+        data.resize(WIRE_FRAME_HEADER_SIZE);
+        writeFrameHeader(static_cast<uint32_t>(payload.size()), data.data());
+        data.append(payload);
+    } else {
+        data = QJsonDocument(msg).toJson(QJsonDocument::Compact) + "\n" ;
+    }
+    qDebug() << "Sending Message:" << msg ;
     if ( socket->state() == QAbstractSocket::ConnectedState ){
         socket->write(data);
     }
 }
 
+bool ApiClient::writeParameter(int componentId, ParameterType p, double value){
+    return sharedParameters_.write(componentId, p, value);
+}
+
 // slot functions
 
 void ApiClient::onReadyRead() {
     buffer.append(socket->readAll());
 
     while (true){
+        if ( receiveFormat_ == WireFormat::CBOR ){
+            if ( buffer.size() < static_cast<qsizetype>(WIRE_FRAME_HEADER_SIZE) ) break ;
+            qsizetype size = readFrameHeader(buffer.constData());
+            if ( buffer.size() < static_cast<qsizetype>(WIRE_FRAME_HEADER_SIZE) + size ) break ;
+
+            QCborParserError err ;
+            QCborValue value = QCborValue::fromCbor(buffer.mid(WIRE_FRAME_HEADER_SIZE, size), &err);
+            buffer.remove(0, WIRE_FRAME_HEADER_SIZE + size);
+            if ( err.error == QCborError::NoError && value.isMap() ){
+                onMessageReceived(value.toMap().toJsonObject());
+            } else {
+                qWarning() << "Invalid CBOR received:" << err.errorString() ;
+            }
+            continue ;
+        }
+
         int endMessageIndex = buffer.indexOf('\n');
         if ( endMessageIndex == -1 )  break ;
 
@@ -68,19 +112,61 @@ void ApiClient::onReadyRead() {
         QJsonParseError err ;
         QJsonDocument doc = QJsonDocument::fromJson(line, &err);
         if ( err.error == QJsonParseError::NoError && doc.isObject() ){
-            qDebug() << "Api Response Received" << doc.object() ;
-            emit dataReceived(doc.object());
+            onMessageReceived(doc.object());
         } else {
             qWarning() << "Invalid JSON received:" << line ;
         }
     }
 }
 
+void ApiClient::onMessageReceived(const QJsonObject& msg){
+    qDebug() << "Api Response Received" << msg ;
+    if ( msg["action"] == "set_protocol" ){
+        if ( msg["status"] == "success" ){
+            receiveFormat_ = sendFormat_ ;
+        } else {
+            // the backend kept the old format, so follow it
+            qWarning() << "wire format negotiation failed:" << msg["error"].toString() ;
+            sendFormat_ = receiveFormat_ ;
+        }
+        return ;
+    }
+    if ( msg["action"] == "get_shared_memory" ){
+        if ( msg["status"] == "success" ){
+            std::string name = msg["data"].toObject()["name"].toString().toStdString();
+            if ( sharedParameters_.open(name) ){
+                qInfo() << "writing parameters through shared memory" << QString::fromStdString(name) ;
+            }
+        } else {
+            qInfo() << "shared memory not available:" << msg["error"].toString() ;
+        }
+        return ;
+    }
+    emit dataReceived(msg);
+}
+
 void ApiClient::onConnected() {
+    buffer.clear();
+    sendFormat_ = WireFormat::JSON ;
+    receiveFormat_ = WireFormat::JSON ;
+    // asked in json before negotiating, so it still arrives if the backend rejects the format
+    if ( useSharedMemory_ ){
+        QJsonObject obj ;
+        obj["action"] = "get_shared_memory" ;
+        sendMessage(obj);
+    }
+    if ( requestedFormat_ != WireFormat::JSON ){
+        QJsonObject obj ;
+        obj["action"] = "set_protocol" ;
+        obj["format"] = QString::fromStdString(wireFormat2String(requestedFormat_));
+        sendMessage(obj);
+        sendFormat_ = requestedFormat_ ;
+    }
     emit connected();
 }
 
 void ApiClient::onDisconnected() {
+    sharedParameters_.close();
     emit disconnected();
 }
 
@@ -24,6 +24,9 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 
+#include "types/WireFormat.hpp"
+#include "ipc/SharedParameterTable.hpp"
+
 class ApiClient : public QObject
 {
     Q_OBJECT
@@ -31,6 +34,16 @@ private:
     QTcpSocket *socket ;
     QByteArray buffer ;
 
+    // wire encoding negotiated with the backend. The two directions switch at different
+    // points in the stream: outgoing right after set_protocol is sent, incoming once its reply arrives
+    WireFormat requestedFormat_ = WireFormat::JSON ;
+    WireFormat sendFormat_ = WireFormat::JSON ;
+    WireFormat receiveFormat_ = WireFormat::JSON ;
+
+    // shared memory parameter table, mapped when the backend runs on this host and offers one
+    bool useSharedMemory_ = false ;
+    SharedParameterTable sharedParameters_ ;
+
     explicit ApiClient(QObject* parent = nullptr);
     ~ApiClient() = default ;
     
@@ -44,6 +57,9 @@ public:
     void connectToBackend();
     void sendMessage(const QJsonObject &obj);
 
+    // writes a parameter target through shared memory, returns false if the socket API must be used
+    bool writeParameter(int componentId, ParameterType p, double value);
+
 signals:
     void connected();
     void disconnected();
@@ -52,6 +68,7 @@ signals:
 
 private slots:
     void onReadyRead();
+    void onMessageReceived(const QJsonObject& msg);
     void onConnected();
     void onDisconnected();
     void onErrorOccurred(QAbstractSocket::SocketError socketError);
@@ -58,6 +58,9 @@ void ComponentManager::requestRemoveComponent(int componentId){
 }
 
 void ComponentManager::requestParameterUpdate(int componentId, ParameterType p, ParameterValue v){
+    double value = std::visit([](auto x){ return static_cast<double>(x); }, v);
+    if ( ApiClient::instance()->writeParameter(componentId, p, value) ) return ;
+
     QJsonObject obj ;
     obj["action"] = "set_parameter" ;
     obj["componentId"] = componentId ;
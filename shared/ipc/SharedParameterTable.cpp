@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ipc/SharedParameterTable.hpp"
+
+#include <fcntl.h>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <spdlog/spdlog.h>
+
+SharedParameterTable::~SharedParameterTable(){
+    close();
+}
+
+std::string SharedParameterTable::defaultName(){
+    return "/syndesium-params-" + std::to_string(getpid());
+}
+
+bool SharedParameterTable::create(const std::string& name){
+    close();
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if ( fd < 0 ){
+        SPDLOG_WARN("shm_open({}) failed: {}", name, strerror(errno));
+        return false ;
+    }
+    if ( ftruncate(fd, sizeof(SharedParameterLayout)) < 0 ){
+        SPDLOG_WARN("ftruncate({}) failed: {}", name, strerror(errno));
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false ;
+    }
+
+    void* mem = mmap(nullptr, sizeof(SharedParameterLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if ( mem == MAP_FAILED ){
+        SPDLOG_WARN("mmap({}) failed: {}", name, strerror(errno));
+        shm_unlink(name.c_str());
+        return false ;
+    }
+
+    // the object is zero filled; construct in place and publish the header last
+    layout_ = new (mem) SharedParameterLayout ;
+    layout_->maxComponents = SharedParameterLayout::MAX_COMPONENTS ;
+    layout_->nParameters = N_PARAMETER_TYPES ;
+    layout_->version = SharedParameterLayout::VERSION ;
+    std::atomic_thread_fence(std::memory_order_release);
+    layout_->magic = SharedParameterLayout::MAGIC ;
+
+    name_ = name ;
+    owner_ = true ;
+    SPDLOG_INFO("shared parameter table created at {}", name_);
+    return true ;
+}
+
+bool SharedParameterTable::open(const std::string& name){
+    close();
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if ( fd < 0 ){
+        SPDLOG_WARN("shm_open({}) failed: {}", name, strerror(errno));
+        return false ;
+    }
+
+    struct stat st ;
+    if ( fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(SharedParameterLayout) ){
+        SPDLOG_WARN("shared parameter table {} has an unexpected size", name);
+        ::close(fd);
+        return false ;
+    }
+
+    void* mem = mmap(nullptr, sizeof(SharedParameterLayout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if ( mem == MAP_FAILED ){
+        SPDLOG_WARN("mmap({}) failed: {}", name, strerror(errno));
+        return false ;
+    }
+
+    auto* layout = static_cast<SharedParameterLayout*>(mem);
+    if ( layout->magic != SharedParameterLayout::MAGIC || 
+         layout->version != SharedParameterLayout::VERSION ||
+         layout->maxComponents != SharedParameterLayout::MAX_COMPONENTS ||
+         layout->nParameters != N_PARAMETER_TYPES 
+    ){
+        SPDLOG_WARN("shared parameter table {} has an incompatible layout", name);
+        munmap(mem, sizeof(SharedParameterLayout));
+        return false ;
+    }
+
+    layout_ = layout ;
+    name_ = name ;
+    owner_ = false ;
+    return true ;
+}
+
+void SharedParameterTable::close(){
+    if ( !layout_ ) return ;
+    munmap(layout_, sizeof(SharedParameterLayout));
+    if ( owner_ ) shm_unlink(name_.c_str());
+    layout_ = nullptr ;
+    name_.clear();
+    owner_ = false ;
+}
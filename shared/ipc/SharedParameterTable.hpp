@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SHARED_PARAMETER_TABLE_HPP_
+#define __SHARED_PARAMETER_TABLE_HPP_
+
+#include "types/ParameterType.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/*
+Memory layout of the shared parameter table. Clients on the same host write parameter
+targets directly into the table; the engine's audio thread picks up everything marked
+dirty at the start of each block. Structural changes still go through the socket API.
+
+A writer stores the value, then sets the parameter's bit in the component's dirty mask,
+then the component's bit in the pending mask. The reader clears masks in the opposite
+order, so a value is never lost, at worst it is applied twice.
+*/
+struct SharedParameterLayout {
+    static constexpr uint32_t MAGIC = 0x53594E50 ; // "SYNP"
+    static constexpr uint32_t VERSION = 1 ;
+    static constexpr size_t MAX_COMPONENTS = 1024 ;
+    static constexpr size_t PENDING_WORDS = MAX_COMPONENTS / 64 ;
+
+    uint32_t magic ;
+    uint32_t version ;
+    uint32_t maxComponents ;
+    uint32_t nParameters ;
+
+    alignas(64) std::atomic<uint64_t> pending[PENDING_WORDS] ;   // components with dirty parameters
+    alignas(64) std::atomic<uint64_t> dirty[MAX_COMPONENTS] ;    // dirty parameters, per component
+    alignas(64) std::atomic<double> values[MAX_COMPONENTS][N_PARAMETER_TYPES] ;
+};
+
+static_assert(N_PARAMETER_TYPES <= 64, "dirty masks hold one bit per parameter type");
+static_assert(std::atomic<double>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+    "shared memory atomics must be lock free");
+
+/**
+ * @brief a mapping of the shared parameter table, either owned (engine) or opened (client)
+ */
+class SharedParameterTable {
+private:
+    SharedParameterLayout* layout_ = nullptr ;
+    std::string name_ ;
+    bool owner_ = false ;
+
+public:
+    SharedParameterTable() = default ;
+    ~SharedParameterTable();
+    SharedParameterTable(const SharedParameterTable&) = delete ;
+    SharedParameterTable& operator=(const SharedParameterTable&) = delete ;
+
+    // create (and later unlink) a new POSIX shared memory object
+    bool create(const std::string& name);
+    // map an existing table, fails if the layout doesn't match
+    bool open(const std::string& name);
+    void close();
+
+    bool isOpen() const { return layout_ != nullptr ; }
+    const std::string& getName() const { return name_ ; }
+
+    static std::string defaultName();
+
+    // ---------------- writers ----------------
+
+    /**
+     * @brief set a parameter target
+     * 
+     * @return false if the table isn't mapped or the component id is outside of it
+     */
+    bool write(int componentId, ParameterType p, double value){
+        if ( !layout_ || componentId < 0 || static_cast<size_t>(componentId) >= SharedParameterLayout::MAX_COMPONENTS ) return false ;
+        size_t pi = static_cast<size_t>(p);
+        if ( pi >= N_PARAMETER_TYPES ) return false ;
+
+        layout_->values[componentId][pi].store(value, std::memory_order_relaxed);
+        layout_->dirty[componentId].fetch_or(uint64_t{1} << pi, std::memory_order_release);
+        layout_->pending[componentId / 64].fetch_or(uint64_t{1} << (componentId % 64), std::memory_order_release);
+        return true ;
+    }
+
+    // ---------------- reader (audio thread) ----------------
+
+    /**
+     * @brief hand every value written since the last call to apply(componentId, ParameterType, value)
+     * 
+     * Component ids at or above limit are newer than what the reader knows about yet, their
+     * values stay pending for a later call.
+     */
+    template <typename F>
+    void drain(F&& apply, size_t limit = SharedParameterLayout::MAX_COMPONENTS){
+        if ( !layout_ ) return ;
+
+        for ( size_t w = 0 ; w < SharedParameterLayout::PENDING_WORDS ; ++w ){
+            if ( layout_->pending[w].load(std::memory_order_relaxed) == 0 ) continue ;
+            uint64_t components = layout_->pending[w].exchange(0, std::memory_order_acquire);
+            uint64_t deferred = 0 ;
+
+            while ( components ){
+                int bit = std::countr_zero(components);
+                components &= components - 1 ;
+                int id = static_cast<int>(w * 64 + bit);
+                if ( static_cast<size_t>(id) >= limit ){
+                    deferred |= uint64_t{1} << bit ;
+                    continue ;
+                }
+
+                uint64_t params = layout_->dirty[id].exchange(0, std::memory_order_acquire);
+                while ( params ){
+                    int p = std::countr_zero(params);
+                    params &= params - 1 ;
+                    apply(id, static_cast<ParameterType>(p), layout_->values[id][p].load(std::memory_order_relaxed));
+                }
+            }
+            if ( deferred ) layout_->pending[w].fetch_or(deferred, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief drop anything written for a component id that doesn't exist (yet or anymore)
+     * 
+     * Called when the id is handed out and once its component is gone, so values meant for
+     * another component never reach the one holding the id.
+     */
+    void discard(int componentId){
+        if ( !layout_ || componentId < 0 || static_cast<size_t>(componentId) >= SharedParameterLayout::MAX_COMPONENTS ) return ;
+        layout_->pending[componentId / 64].fetch_and(~(uint64_t{1} << (componentId % 64)), std::memory_order_relaxed);
+        layout_->dirty[componentId].store(0, std::memory_order_relaxed);
+    }
+};
+
+#endif // __SHARED_PARAMETER_TABLE_HPP_
@@ -36,6 +36,7 @@ struct ConnectionRequest {
     std::optional<ParameterType> inboundParameter ;
     bool depthConnection = false ;
     bool remove = false ;
+    bool feedback = false ; // signal only, set by the engine when the connection closes a cycle
 
     bool operator==(const ConnectionRequest& other) const {
         return inboundSocket == other.inboundSocket &&
@@ -97,6 +98,7 @@ inline void to_json(json& j, const ConnectionRequest& req){
     if ( req.outboundID.has_value() ) j["outbound"]["componentId"] = req.outboundID.value();
     if ( req.outboundIdx.has_value() ) j["outbound"]["index"] = req.outboundIdx.value();
     if ( req.inboundParameter.has_value() ) j["inbound"]["parameter"] = req.inboundParameter.value();
+    if ( req.feedback ) j["feedback"] = true ;
 }
 
 inline void from_json(const json& j, ConnectionRequest& req){
@@ -115,6 +117,7 @@ inline void from_json(const json& j, ConnectionRequest& req){
         req.outboundIdx = outbound.at("index");
     if ( inbound.contains("parameter") ) 
         req.inboundParameter = static_cast<ParameterType>(inbound.at("parameter"));
+    req.feedback = j.value("feedback", false);
 
     if ( j.at("action") == "create_connection" ){
         req.remove = false ;
@@ -31,7 +31,7 @@ using ParameterValue = std::variant<bool, uint8_t, int, float, double>;
 /*
 To add a ParameterType, the following is required:
 1. add it to the X Macro PARAMETER_TYPE_LIST
-2. Define the specialized ParameterTraits struct
+2. Define the specialized ParameterTraits struct (including its SmoothingPolicy)
 
 */ 
 
@@ -106,6 +106,20 @@ enum class ModulationStrategy : uint8_t {
 ModulationStrategy modStrategyFromString(std::string str);
 std::string modStrategyToString(ModulationStrategy str);
 
+/*
+parameters that are set from outside the audio thread (e.g., a GUI slider) can declare
+a smoothing policy. The API only sets the target value; the audio thread computes a
+ramp towards it at the start of each block and advances it per sample.
+
+Each ParameterTraits specialization sets smoothing to its policy and smoothingMs to the
+ramp length (LINEAR) or time constant (ONE_POLE) in milliseconds, 0 when smoothing is NONE.
+*/
+enum class SmoothingPolicy : uint8_t {
+    NONE,     // jump to the target immediately
+    LINEAR,   // linear ramp reaching the target after smoothingMs
+    ONE_POLE  // exponential approach with a time constant of smoothingMs
+};
+
 // Parameter Traits access
 template <ParameterType Type> struct ParameterTraits ;
 
@@ -117,6 +131,8 @@ template <> struct ParameterTraits<ParameterType::SCALAR>{
     static constexpr float maximum = 1.0 ;
     static constexpr float defaultValue = 1.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::ADDITIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::LINEAR ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -127,6 +143,8 @@ template <> struct ParameterTraits<ParameterType::DELAY>{
     static constexpr float maximum = 48000 * 4.0 ;
     static constexpr float defaultValue = 0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::ADDITIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -137,6 +155,8 @@ template <> struct ParameterTraits<ParameterType::DEPTH>{
     static constexpr float maximum = 1.0 ;
     static constexpr float defaultValue = 1.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::ADDITIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 2 ; // num decimals
 };
 
@@ -147,6 +167,8 @@ template <> struct ParameterTraits<ParameterType::STATUS>{
     static constexpr float maximum = 1 ;
     static constexpr float defaultValue = 1 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -157,6 +179,8 @@ template <> struct ParameterTraits<ParameterType::WAVEFORM>{
     static constexpr float maximum = Waveform::N ;
     static constexpr float defaultValue = Waveform::SINE ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -167,6 +191,8 @@ template <> struct ParameterTraits<ParameterType::FREQUENCY>{
     static constexpr float maximum = 30000.0 ;
     static constexpr float defaultValue = 440.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::ONE_POLE ;
+    static constexpr float smoothingMs = 10.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -177,6 +203,8 @@ template <> struct ParameterTraits<ParameterType::AMPLITUDE>{
     static constexpr float maximum = 1.0 ;
     static constexpr float defaultValue = 1.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::LOGARITHMIC ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::LINEAR ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -187,6 +215,8 @@ template <> struct ParameterTraits<ParameterType::GAIN>{
     static constexpr float maximum = 1.0 ;
     static constexpr float defaultValue = 1.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::LOGARITHMIC ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::LINEAR ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -197,6 +227,8 @@ template <> struct ParameterTraits<ParameterType::DBGAIN>{
     static constexpr float maximum = 24.0 ;
     static constexpr float defaultValue = 0.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::ADDITIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::LINEAR ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -207,6 +239,8 @@ template <> struct ParameterTraits<ParameterType::PHASE>{
     static constexpr float maximum = 1.0 ;
     static constexpr float defaultValue = 1.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::ADDITIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -217,6 +251,8 @@ template <> struct ParameterTraits<ParameterType::PAN>{
     static constexpr float maximum = 1.0 ;
     static constexpr float defaultValue = 0.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::ADDITIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::LINEAR ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -227,6 +263,8 @@ template <> struct ParameterTraits<ParameterType::DETUNE>{
     static constexpr float maximum = 1250.0f ;
     static constexpr float defaultValue = 0.0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::ONE_POLE ;
+    static constexpr float smoothingMs = 10.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -237,6 +275,8 @@ template <> struct ParameterTraits<ParameterType::ATTACK>{
     static constexpr float maximum = 4.00 ;
     static constexpr float defaultValue = 0.01 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -247,6 +287,8 @@ template <> struct ParameterTraits<ParameterType::DECAY>{
     static constexpr float maximum = 4.0 ;
     static constexpr float defaultValue = 0.01 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -257,6 +299,8 @@ template <> struct ParameterTraits<ParameterType::SUSTAIN>{
     static constexpr float maximum = 1.0 ;
     static constexpr float defaultValue = 0.8 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::ADDITIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::LINEAR ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -267,6 +311,8 @@ template <> struct ParameterTraits<ParameterType::RELEASE>{
     static constexpr float maximum = 4.0 ;
     static constexpr float defaultValue = 0.01 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -277,6 +323,8 @@ template <> struct ParameterTraits<ParameterType::FILTER_TYPE>{
     static constexpr float maximum = FilterType::N ;
     static constexpr float defaultValue = FilterType::LowPass ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -287,6 +335,8 @@ template <> struct ParameterTraits<ParameterType::CUTOFF>{
     static constexpr float maximum = 30000.0f ;
     static constexpr float defaultValue = 20000.0f ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::ONE_POLE ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -297,6 +347,8 @@ template <> struct ParameterTraits<ParameterType::BANDWIDTH>{
     static constexpr float maximum = 4.0f ;
     static constexpr float defaultValue = 2.0f ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::ONE_POLE ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -307,6 +359,8 @@ template <> struct ParameterTraits<ParameterType::SHELF>{
     static constexpr float maximum = 2.0f ;
     static constexpr float defaultValue = 1.0f ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::ONE_POLE ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -317,6 +371,8 @@ template <> struct ParameterTraits<ParameterType::Q_FACTOR>{
     static constexpr float maximum = 10.0f ;
     static constexpr float defaultValue = 0.5f ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::EXPONENTIAL ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::ONE_POLE ;
+    static constexpr float smoothingMs = 20.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -327,6 +383,8 @@ template <> struct ParameterTraits<ParameterType::BPM>{
     static constexpr float maximum = 300 ;
     static constexpr float defaultValue = 120 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::MULTIPLICATIVE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -337,6 +395,8 @@ template <> struct ParameterTraits<ParameterType::MIDI_VALUE>{
     static constexpr float maximum = 127 ;
     static constexpr float defaultValue = 69 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -347,6 +407,8 @@ template <> struct ParameterTraits<ParameterType::VELOCITY>{
     static constexpr float maximum = 127 ;
     static constexpr float defaultValue = 100 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -357,6 +419,8 @@ template <> struct ParameterTraits<ParameterType::START_POSITION>{
     static constexpr float maximum = 64 ;
     static constexpr float defaultValue = 0 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -367,6 +431,8 @@ template <> struct ParameterTraits<ParameterType::DURATION>{
     static constexpr float maximum = 64 ;
     static constexpr float defaultValue = 1 ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 3 ; // num decimals
 };
 
@@ -377,6 +443,8 @@ template <> struct ParameterTraits<ParameterType::SCALE_NOTE>{
     static constexpr float maximum = ScaleNote::N ;
     static constexpr float defaultValue = ScaleNote::C ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
 
@@ -387,6 +455,8 @@ template <> struct ParameterTraits<ParameterType::SCALE_TYPE>{
     static constexpr float maximum = ScaleType::N ;
     static constexpr float defaultValue = ScaleType::MAJOR ;
     static constexpr ModulationStrategy defaultStrategy = ModulationStrategy::NONE ;
+    static constexpr SmoothingPolicy smoothing = SmoothingPolicy::NONE ;
+    static constexpr float smoothingMs = 0.0f ;
     static constexpr size_t uiPrecision = 0 ; // num decimals
 };
   
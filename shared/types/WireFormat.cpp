@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "types/WireFormat.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+
+const std::string wireFormat2String(WireFormat f){
+    return std::string(wireFormatStrings[static_cast<int>(f)]);
+}
+
+WireFormat wireFormatFromString(std::string str) {
+    auto it = std::find(wireFormatStrings.begin(), wireFormatStrings.end(), str);
+    if (it != wireFormatStrings.end()) {
+        return static_cast<WireFormat>(std::distance(wireFormatStrings.begin(), it));
+    }
+    throw std::invalid_argument("Unknown wire format: " + str);
+}
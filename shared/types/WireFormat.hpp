@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SHARED_WIRE_FORMAT_HPP_
+#define __SHARED_WIRE_FORMAT_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+Encoding of messages on the control API connection. Every connection starts out as
+newline-delimited JSON; a client can switch to a binary encoding with the "set_protocol"
+action. Binary messages are framed with a 4-byte big-endian payload length.
+
+The switch happens at the same point in the stream for both peers: the client encodes
+everything after its set_protocol request in the new format, and the server replies to
+set_protocol in the old format before switching.
+*/
+enum class WireFormat {
+    JSON,
+    MSGPACK,
+    CBOR,
+    N_WIRE_FORMATS
+};
+
+constexpr int N_WIRE_FORMATS = static_cast<int>(WireFormat::N_WIRE_FORMATS) ;
+
+constexpr std::array<std::string_view, N_WIRE_FORMATS> wireFormatStrings({
+    "json",
+    "msgpack",
+    "cbor"
+});
+
+constexpr size_t WIRE_FRAME_HEADER_SIZE = 4 ;
+constexpr uint32_t WIRE_MAX_FRAME_SIZE = 64 * 1024 * 1024 ;
+
+const std::string wireFormat2String(WireFormat f);
+WireFormat wireFormatFromString(std::string str);
+
+inline void writeFrameHeader(uint32_t size, char* out){
+    out[0] = static_cast<char>((size >> 24) & 0xFF);
+    out[1] = static_cast<char>((size >> 16) & 0xFF);
+    out[2] = static_cast<char>((size >> 8) & 0xFF);
+    out[3] = static_cast<char>(size & 0xFF);
+}
+
+inline uint32_t readFrameHeader(const char* in){
+    return (static_cast<uint32_t>(static_cast<uint8_t>(in[0])) << 24) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(in[1])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(in[2])) << 8)  |
+            static_cast<uint32_t>(static_cast<uint8_t>(in[3])) ;
+}
+
+#endif // __SHARED_WIRE_FORMAT_HPP_
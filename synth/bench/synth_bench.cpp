@@ -0,0 +1,425 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "core/Engine.hpp"
+#include "config/Config.hpp"
+#include "api/ApiHandler.hpp"
+#include "diagnostics/RtCheck.hpp"
+#include "requests/ConnectionRequest.hpp"
+#include "types/ComponentType.hpp"
+#include "types/ParameterType.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+/**
+ * Renders synthetic patches through the engine without an audio device and reports
+ * per-sample cost, realtime factor and block time statistics. The cost of a single
+ * structural edit on each patch, one connection made or removed, is measured as well.
+ *
+ * usage: synth_bench [--seconds S] [--repeats R] [--buffer N] [--filter name] [--profile] [--json]
+ *
+ * --profile runs with module profiling on, which shows its overhead and adds the
+ * per component loads of the last window to the json output.
+*/
+
+namespace {
+
+    struct Options {
+        double seconds = 5.0 ;
+        int repeats = 5 ;
+        unsigned int bufferSize = 0 ; // 0 keeps audio.buffer_size
+        std::string filter ;
+        bool profile = false ;
+        bool json = false ;
+    };
+
+    struct Result {
+        std::string name ;
+        size_t components ;
+        double nsPerSample ; // median over repeats
+        double nsPerSampleMin ;
+        double realtimeFactor ;
+        double blockMeanUs ;
+        double blockP99Us ;
+        double blockMaxUs ;
+        double editUs ; // median over edits, plan rebuild included
+        json modules ; // get_module_stats components, with --profile
+    };
+
+    // builds a patch through the same api requests a client sends
+    class Patch {
+    private:
+        Engine& engine_ ;
+        size_t components_ = 0 ;
+
+    public:
+        Patch(Engine& engine):
+            engine_(engine)
+        {}
+
+        size_t size() const { return components_ ; }
+
+        int add(ComponentType type){
+            json r = request({{"action", "add_component"}, {"type", type}, {"name", "bench"}});
+            ++components_ ;
+            return r["componentId"] ;
+        }
+
+        void set(int id, ParameterType p, double value){
+            request({{"action", "set_parameter"}, {"componentId", id}, {"parameter", p}, {"value", value}, {"smooth", false}});
+        }
+
+        void signal(int from, int to, size_t input = 0, bool remove = false){
+            ConnectionRequest c ;
+            c.outboundSocket = SocketType::SignalOutbound ;
+            c.inboundSocket = SocketType::SignalInbound ;
+            c.outboundID = from ;
+            c.outboundIdx = 0 ;
+            if ( to >= 0 ) c.inboundID = to ;
+            c.inboundIdx = input ;
+            c.remove = remove ;
+            request(c);
+        }
+
+        void sink(int from, bool remove = false){
+            signal(from, -1, 0, remove);
+        }
+
+        void modulate(int from, int to, ParameterType p){
+            ConnectionRequest c ;
+            c.outboundSocket = SocketType::ModulationOutbound ;
+            c.inboundSocket = SocketType::ModulationInbound ;
+            c.outboundID = from ;
+            c.inboundID = to ;
+            c.inboundParameter = p ;
+            request(c);
+        }
+
+        // listen to the engine's root midi handler
+        void midi(int id){
+            ConnectionRequest c ;
+            c.outboundSocket = SocketType::MidiOutbound ;
+            c.inboundSocket = SocketType::MidiInbound ;
+            c.inboundID = id ;
+            request(c);
+        }
+
+        void noteOn(unsigned char note){
+            std::vector<unsigned char> message{0x90, note, 100} ;
+            MidiController::onMidiEvent(0.0, &message, &engine_.midiController);
+        }
+
+    private:
+        json request(const json& r){
+            json response = ApiHandler::instance()->handleRequest(r);
+            if ( response.value("status", "") != "success" ){
+                throw std::runtime_error(response.value("error", "request failed") + ": " + r.dump());
+            }
+            return response ;
+        }
+    };
+
+    // ---------------- patch corpus ----------------
+
+    void oscillators(Patch& p, int n){
+        for ( int i = 0 ; i < n ; ++i ){
+            int osc = p.add(ComponentType::Oscillator);
+            p.set(osc, ParameterType::FREQUENCY, 110.0 + 7.0 * i);
+            p.sink(osc);
+        }
+    }
+
+    void polyphony(Patch& p, int voices){
+        int poly = p.add(ComponentType::PolyOscillator);
+        int env = p.add(ComponentType::ADSREnvelope);
+        p.midi(poly);
+        p.midi(env);
+        p.modulate(env, poly, ParameterType::AMPLITUDE);
+        p.sink(poly);
+        for ( int i = 0 ; i < voices ; ++i ) p.noteOn(36 + i);
+    }
+
+    void biquadCascade(Patch& p, int n){
+        int prev = p.add(ComponentType::Oscillator);
+        for ( int i = 0 ; i < n ; ++i ){
+            int bq = p.add(ComponentType::BiquadFilter);
+            p.set(bq, ParameterType::FREQUENCY, 500.0 + 100.0 * i);
+            p.signal(prev, bq);
+            prev = bq ;
+        }
+        p.sink(prev);
+    }
+
+    // a chain of delays whose end feeds back into its start
+    void delayNetwork(Patch& p, int n){
+        int osc = p.add(ComponentType::Oscillator);
+        int first = -1, prev = osc ;
+        for ( int i = 0 ; i < n ; ++i ){
+            int d = p.add(ComponentType::Delay);
+            p.set(d, ParameterType::DELAY, 1000.0 + 331.0 * i);
+            p.set(d, ParameterType::GAIN, 0.7);
+            p.signal(prev, d);
+            if ( first < 0 ) first = d ;
+            prev = d ;
+        }
+        p.signal(prev, first);
+        p.sink(prev);
+    }
+
+    // every oscillator modulates the frequency of the next one
+    void modulationChain(Patch& p, int n){
+        int prev = p.add(ComponentType::Oscillator);
+        p.set(prev, ParameterType::FREQUENCY, 0.5);
+        for ( int i = 1 ; i < n ; ++i ){
+            int osc = p.add(ComponentType::Oscillator);
+            p.set(osc, ParameterType::FREQUENCY, 1.0 + i);
+            p.modulate(prev, osc, ParameterType::FREQUENCY);
+            prev = osc ;
+        }
+        p.sink(prev);
+    }
+
+    // fixed seed, so every run measures the same graph
+    void randomDag(Patch& p, int n){
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::vector<int> ids ;
+        std::vector<bool> hasOutput ;
+
+        int nSources = std::max(1, n / 16);
+        for ( int i = 0 ; i < n ; ++i ){
+            int id ;
+            if ( i < nSources ){
+                id = p.add(ComponentType::Oscillator);
+                p.set(id, ParameterType::FREQUENCY, 50.0 + 1000.0 * uniform(rng));
+            } else {
+                double r = uniform(rng);
+                if ( r < 0.45 ){
+                    id = p.add(ComponentType::BiquadFilter);
+                    p.set(id, ParameterType::FREQUENCY, 200.0 + 5000.0 * uniform(rng));
+                } else if ( r < 0.95 ){
+                    id = p.add(ComponentType::Multiply);
+                    p.set(id, ParameterType::SCALAR, 0.5 + uniform(rng));
+                } else {
+                    id = p.add(ComponentType::Delay);
+                    p.set(id, ParameterType::DELAY, 100.0 + 4000.0 * uniform(rng));
+                }
+
+                int nInputs = 1 + static_cast<int>(uniform(rng) * 3);
+                for ( int k = 0 ; k < nInputs ; ++k ){
+                    size_t from = std::uniform_int_distribution<size_t>(0, ids.size() - 1)(rng);
+                    p.signal(ids[from], id);
+                    hasOutput[from] = true ;
+                }
+            }
+            ids.push_back(id);
+            hasOutput.push_back(false);
+        }
+
+        for ( size_t i = 0 ; i < ids.size() ; ++i ){
+            if ( !hasOutput[i] ) p.sink(ids[i]);
+        }
+    }
+
+    struct Case {
+        std::string name ;
+        std::function<void(Patch&)> build ;
+    };
+
+    std::vector<Case> corpus(){
+        return {
+            {"oscillators_16", [](Patch& p){ oscillators(p, 16); }},
+            {"oscillators_64", [](Patch& p){ oscillators(p, 64); }},
+            {"poly_adsr_8", [](Patch& p){ polyphony(p, 8); }},
+            {"poly_adsr_32", [](Patch& p){ polyphony(p, 32); }},
+            {"biquad_cascade_8", [](Patch& p){ biquadCascade(p, 8); }},
+            {"biquad_cascade_32", [](Patch& p){ biquadCascade(p, 32); }},
+            {"delay_network_8", [](Patch& p){ delayNetwork(p, 8); }},
+            {"modulation_chain_16", [](Patch& p){ modulationChain(p, 16); }},
+            {"random_dag_500", [](Patch& p){ randomDag(p, 500); }},
+        };
+    }
+
+    // ---------------- measurement ----------------
+
+    constexpr int EDITS = 200 ;
+
+    double percentile(std::vector<double> v, double q){
+        if ( v.empty() ) return 0.0 ;
+        size_t k = static_cast<size_t>(q * ( v.size() - 1 ));
+        std::nth_element(v.begin(), v.begin() + k, v.end());
+        return v[k] ;
+    }
+
+    Result run(const Case& c, const Options& options){
+        Engine engine ;
+        engine.prepareRender();
+        engine.moduleProfiler.setEnabled(options.profile);
+        Patch patch(engine);
+        c.build(patch);
+
+        const double sampleRate = engine.getSampleRate();
+        const unsigned int block = Config::get<unsigned int>("audio.buffer_size").value();
+        const size_t frames = static_cast<size_t>(options.seconds * sampleRate);
+        const size_t nBlocks = ( frames + block - 1 ) / block ;
+        std::vector<double> buffer(block);
+
+        // warm caches, voices and smoothing before measuring
+        for ( size_t b = 0 ; b < nBlocks / 4 + 1 ; ++b ) engine.renderBlock(buffer.data(), block);
+
+        std::vector<double> perSample ;
+        std::vector<double> blockTimes ;
+        blockTimes.reserve(nBlocks * options.repeats);
+        using clock = std::chrono::steady_clock ;
+
+        for ( int r = 0 ; r < options.repeats ; ++r ){
+            double total = 0.0 ;
+            for ( size_t b = 0 ; b < nBlocks ; ++b ){
+                auto start = clock::now();
+                {
+                    RtCheck::Scope realtime ;
+                    engine.renderBlock(buffer.data(), block);
+                }
+                double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+                blockTimes.push_back(ns);
+                total += ns ;
+            }
+            perSample.push_back(total / ( nBlocks * block ));
+        }
+
+        // one extra stage toggled on and off the output, every edit publishes a new plan
+        size_t components = patch.size();
+        int probe = patch.add(ComponentType::Multiply);
+        std::vector<double> editTimes ;
+        for ( int e = 0 ; e < EDITS ; ++e ){
+            auto start = clock::now();
+            patch.sink(probe, e % 2 == 1);
+            editTimes.push_back(std::chrono::duration<double, std::micro>(clock::now() - start).count());
+            // adopting the plan lets the next edit free the retired ones
+            engine.renderBlock(buffer.data(), block);
+        }
+
+        Result result ;
+        result.name = c.name ;
+        result.components = components ;
+        result.nsPerSample = percentile(perSample, 0.5);
+        result.nsPerSampleMin = *std::min_element(perSample.begin(), perSample.end());
+        result.realtimeFactor = 1e9 / ( sampleRate * result.nsPerSample );
+        double sum = 0.0 ;
+        for ( double t : blockTimes ) sum += t ;
+        result.blockMeanUs = sum / blockTimes.size() * 1e-3 ;
+        result.blockP99Us = percentile(blockTimes, 0.99) * 1e-3 ;
+        result.blockMaxUs = *std::max_element(blockTimes.begin(), blockTimes.end()) * 1e-3 ;
+        result.editUs = percentile(editTimes, 0.5);
+        if ( options.profile ){
+            result.modules = ApiHandler::instance()->handleRequest({{"action", "get_module_stats"}})["data"]["components"] ;
+        }
+        return result ;
+    }
+
+    bool parseArgs(int argc, char** argv, Options& options){
+        for ( int i = 1 ; i < argc ; ++i ){
+            std::string arg = argv[i] ;
+            if ( arg == "--json" ){
+                options.json = true ;
+                continue ;
+            }
+            if ( arg == "--profile" ){
+                options.profile = true ;
+                continue ;
+            }
+            if ( i + 1 >= argc ) return false ;
+            std::string value = argv[++i] ;
+            try {
+                if ( arg == "--seconds" ) options.seconds = std::stod(value);
+                else if ( arg == "--repeats" ) options.repeats = std::stoi(value);
+                else if ( arg == "--buffer" ) options.bufferSize = std::stoul(value);
+                else if ( arg == "--filter" ) options.filter = value ;
+                else return false ;
+            } catch ( const std::exception& ){
+                return false ;
+            }
+        }
+        return options.seconds > 0 && options.repeats > 0 ;
+    }
+}
+
+int main(int argc, char** argv){
+    Options options ;
+    if ( !parseArgs(argc, argv, options) ){
+        std::fprintf(stderr, "usage: %s [--seconds S] [--repeats R] [--buffer N] [--filter name] [--profile] [--json]\n", argv[0]);
+        return 2 ;
+    }
+
+    spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%s:%#] %v");
+    spdlog::set_level(spdlog::level::warn);
+
+    Config::load();
+    if ( options.bufferSize > 0 ) Config::set("audio.buffer_size", options.bufferSize);
+
+    std::vector<Result> results ;
+    for ( const auto& c : corpus() ){
+        if ( !options.filter.empty() && c.name.find(options.filter) == std::string::npos ) continue ;
+        try {
+            results.push_back(run(c, options));
+        } catch ( const std::exception& e ){
+            std::fprintf(stderr, "%s: %s\n", c.name.c_str(), e.what());
+            return 1 ;
+        }
+        if ( !options.json ){
+            const Result& r = results.back() ;
+            std::printf("%-22s %5zu components %9.1f ns/sample (min %.1f) %8.1fx realtime  block mean %8.1f us  p99 %8.1f us  max %8.1f us  edit %8.1f us\n",
+                r.name.c_str(), r.components, r.nsPerSample, r.nsPerSampleMin, r.realtimeFactor, r.blockMeanUs, r.blockP99Us, r.blockMaxUs, r.editUs);
+        }
+    }
+
+    if ( options.json ){
+        json out ;
+        out["sample_rate"] = Config::get<double>("audio.sample_rate").value();
+        out["buffer_size"] = Config::get<unsigned int>("audio.buffer_size").value();
+        out["seconds"] = options.seconds ;
+        out["repeats"] = options.repeats ;
+        out["results"] = json::array();
+        for ( const auto& r : results ){
+            out["results"].push_back({
+                {"name", r.name},
+                {"components", r.components},
+                {"ns_per_sample", r.nsPerSample},
+                {"ns_per_sample_min", r.nsPerSampleMin},
+                {"realtime_factor", r.realtimeFactor},
+                {"block_mean_us", r.blockMeanUs},
+                {"block_p99_us", r.blockP99Us},
+                {"block_max_us", r.blockMaxUs},
+                {"edit_us", r.editUs}
+            });
+            if ( options.profile ) out["results"].back()["modules"] = r.modules ;
+        }
+        if ( RtCheck::ENABLED ) out["realtime_violations"] = RtCheck::report();
+        std::printf("%s\n", out.dump(2).c_str());
+    } else if ( RtCheck::ENABLED ){
+        std::printf("realtime violations: %s\n", RtCheck::report().dump().c_str());
+    }
+    return RtCheck::getTotal() > 0 ? 1 : 0 ;
+}
@@ -18,18 +18,29 @@
 #include "api/ApiHandler.hpp"
 #include "core/BaseComponent.hpp"
 #include "core/Engine.hpp"
+#include "diagnostics/Log.hpp"
+#include "diagnostics/RtCheck.hpp"
+#include "diagnostics/Tracer.hpp"
 #include "config/Config.hpp"
 #include "configs/ComponentConfig.hpp"
 #include "meta/CollectionDescriptor.hpp"
 #include "meta/ComponentRegistry.hpp"
+#include "params/ParameterChange.hpp"
 #include "requests/CollectionRequest.hpp"
 #include "types/ParameterType.hpp"
 #include "types/SocketType.hpp"
 
+#include <array>
+#include <chrono>
+#include <cstring>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <sys/socket.h>
-#include <fcntl.h>
+#include <unistd.h>
 #include <thread>
 #include <optional>
 #include <unordered_map>
@@ -48,13 +59,28 @@ ApiHandler* ApiHandler::instance(){
 
 void ApiHandler::initialize(Engine* engine){
     engine_ = engine ;
+    subscriptions_ = std::make_unique<SubscriptionManager>(&engine->probeTable);
 
     // register api handler functions
+    handlers_["set_protocol"] = [this](int sock, const json& request){ return setProtocol(sock, request); };
     handlers_["get_audio_devices"] = [this](int sock, const json& request){ return getAudioDevices(sock, request); };
     handlers_["get_midi_devices"] = [this](int sock, const json& request){ return getMidiDevices(sock, request); };
     handlers_["set_audio_device"] = [this](int sock, const json& request){ return setAudioDevice(sock, request); };
     handlers_["set_midi_device"] = [this](int sock, const json& request){ return setMidiDevice(sock, request); };
+    handlers_["set_buffer_size"] = [this](int sock, const json& request){ return setBufferSize(sock, request); };
     handlers_["set_state"] = [this](int sock, const json& request){ return setState(sock, request); };
+    handlers_["get_shared_memory"] = [this](int sock, const json& request){ return getSharedMemory(sock, request); };
+    handlers_["get_processing_plan"] = [this](int sock, const json& request){ return getProcessingPlan(sock, request); };
+    handlers_["get_engine_stats"] = [this](int sock, const json& request){ return getEngineStats(sock, request); };
+    handlers_["get_module_stats"] = [this](int sock, const json& request){ return getModuleStats(sock, request); };
+    handlers_["set_module_profiling"] = [this](int sock, const json& request){ return setModuleProfiling(sock, request); };
+    handlers_["set_tracing"] = [this](int sock, const json& request){ return setTracing(sock, request); };
+    handlers_["get_latency_stats"] = [this](int sock, const json& request){ return getLatencyStats(sock, request); };
+    handlers_["set_log_level"] = [this](int sock, const json& request){ return setLogLevel(sock, request); };
+    handlers_["get_realtime_status"] = [this](int sock, const json& request){ return getRealtimeStatus(sock, request); };
+    handlers_["get_governor_status"] = [this](int sock, const json& request){ return getGovernorStatus(sock, request); };
+    handlers_["set_governor"] = [this](int sock, const json& request){ return setGovernor(sock, request); };
+    handlers_["set_component_optional"] = [this](int sock, const json& request){ return setComponentOptional(sock, request); };
     handlers_["get_configuration"] = [this](int sock, const json& request){ return getConfiguration(sock, request); };
     handlers_["load_configuration"] = [this](int sock, const json& request){ return loadConfiguration(sock, request); };
     handlers_["add_component"] = [this](int sock, const json& request){ return addComponent(sock, request); };
@@ -82,13 +108,20 @@ void ApiHandler::initialize(Engine* engine){
     handlers_["set_modulation_strategy"] = [this](int sock, const json& request){ return setModulationStrategy(sock, request); };
     handlers_["get_modulation_depth"] = [this](int sock, const json& request){ return getModulationDepth(sock, request); };
     handlers_["set_modulation_depth"] = [this](int sock, const json& request){ return setModulationDepth(sock, request); };
+    handlers_["subscribe"] = [this](int sock, const json& request){ return subscribe(sock, request); };
+    handlers_["unsubscribe"] = [this](int sock, const json& request){ return unsubscribe(sock, request); };
+    handlers_["batch"] = [this](int sock, const json& request){ return applyBatch(sock, request); };
+
+    // actions that may block for a while (device setup, graph rebuilds) run on the worker pool
+    workerActions_ = { "load_configuration", "batch", "set_audio_device", "set_midi_device", "set_buffer_size", "set_state", "set_tracing" };
 }
 
 void ApiHandler::start(){
+    Tracer::setThreadName("api");
     int serverPort = Config::get<int>("server.port").value() ;
 
     // Create socket
-    int serverSock = socket(AF_INET, SOCK_STREAM, 0);
+    int serverSock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (serverSock == -1) {
         SPDLOG_WARN("Socket creation failed");
         exit(1);
@@ -99,9 +132,6 @@ void ApiHandler::start(){
         exit(1);
     }
 
-    // set socket as nonblocking
-    fcntl(serverSock, F_SETFL, O_NONBLOCK);
-
     sockaddr_in serverAddr;
     serverAddr.sin_family = AF_INET;
     serverAddr.sin_addr.s_addr = INADDR_ANY;
@@ -114,78 +144,450 @@ void ApiHandler::start(){
     }
 
     // Listen for incoming connections
-    if (listen(serverSock, 3) < 0) {
+    if (listen(serverSock, SOMAXCONN) < 0) {
         SPDLOG_WARN("Listen failed");
+        close(serverSock);
         return;
     }
 
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    int wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timerFd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if ( epollFd_ == -1 || wakeFd == -1 || timerFd_ == -1 ){
+        SPDLOG_WARN("failed to create api event loop");
+        close(serverSock);
+        return ;
+    }
+    wakeFd_ = wakeFd ;
+
+    epoll_event ev{} ;
+    ev.events = EPOLLIN ;
+    ev.data.fd = serverSock ;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, serverSock, &ev);
+    ev.data.fd = wakeFd ;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd, &ev);
+    ev.data.fd = timerFd_ ;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, timerFd_, &ev);
+
+    // a stop requested before the loop existed
+    if ( Engine::stop_flag ) stopping_ = true ;
+
+    startWorkers();
+
     SPDLOG_INFO("Server listening on port {}... ",serverPort);
 
-    // Accept incoming client connections in a loop
-    while (!Engine::stop_flag) {
-        int sock = accept(serverSock, nullptr, nullptr);
-        if (sock >= 0) {
-            // set client socket to non-blocking
-            int flags = fcntl(sock, F_GETFL, 0);
-            if ( flags == -1 ){
-                perror("fcntl F_GETFL");
-                close(sock);
+    std::array<epoll_event, 64> events ;
+    while ( !stopping_ ){
+        int n = epoll_wait(epollFd_, events.data(), events.size(), -1);
+        if ( n < 0 ){
+            if ( errno == EINTR ) continue ;
+            perror("epoll_wait");
+            break ;
+        }
+
+        for ( int i = 0 ; i < n ; ++i ){
+            int fd = events[i].data.fd ;
+            uint32_t flags = events[i].events ;
+
+            if ( fd == serverSock ){
+                acceptConnections(serverSock);
                 continue ;
             }
-            if ( fcntl(sock, F_SETFL, flags | O_NONBLOCK ) == -1 ){
-                perror("fcntl F_SETFL");
-                close(sock);
+            if ( fd == wakeFd ){
+                uint64_t count ;
+                while ( read(wakeFd, &count, sizeof(count)) > 0 ){}
+                resumeConnections();
+                continue ;
+            }
+            if ( fd == timerFd_ ){
+                uint64_t expirations ;
+                while ( read(timerFd_, &expirations, sizeof(expirations)) > 0 ){}
+                sendSubscriptionUpdates();
                 continue ;
             }
 
-            // Handle client in a separate thread
-            std::thread([sock](){
-                ApiHandler::instance()->onClientConnection(sock);
-            }).detach();  
-        } else {
-            // no pending connection; sleep briefly to avoid busy-wait
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+            auto conn = getConnection(fd);
+            if ( !conn ) continue ;
+
+            if ( flags & EPOLLOUT ) onWritable(conn);
+            if ( flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR) ) onReadable(conn);
         }
     }
 
-    // Close the server socket
+    SPDLOG_INFO("Stopping API server...");
+    stopWorkers();
+
+    std::vector<std::shared_ptr<Connection>> open ;
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        for ( auto& [fd, conn] : connections_ ) open.push_back(conn);
+    }
+    for ( auto& conn : open ){
+        conn->busy = false ;
+        closeConnection(conn);
+    }
+
+    wakeFd_ = -1 ;
+    close(wakeFd);
+    close(timerFd_);
+    timerFd_ = -1 ;
+    close(epollFd_);
+    epollFd_ = -1 ;
     close(serverSock);
 }
 
-void ApiHandler::onClientConnection(int sock){
-    char buffer[1024] = {0};
-    std::string partialData ;
+void ApiHandler::stop(){
+    // only atomics and write(2) here, this is called from the signal handler
+    stopping_ = true ;
+    wake();
+}
+
+void ApiHandler::wake(){
+    int fd = wakeFd_.load() ;
+    if ( fd < 0 ) return ;
+    uint64_t one = 1 ;
+    ssize_t r = write(fd, &one, sizeof(one));
+    (void)r ;
+}
 
-    while (!Engine::stop_flag){
-        ssize_t bytesReceived = recv(sock, buffer, sizeof(buffer) - 1, 0) ;
-        if (bytesReceived > 0 ){
-            buffer[bytesReceived] = '\0' ; // null-terminate the buffer so it can be read into a string
-            partialData += buffer ; // read buffered text into data string
+void ApiHandler::acceptConnections(int serverSock){
+    while (true){
+        int sock = accept4(serverSock, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if ( sock < 0 ){
+            if ( errno == EINTR ) continue ;
+            if ( errno != EAGAIN && errno != EWOULDBLOCK ) perror("accept");
+            return ;
+        }
 
-            // loop until we find a newline character
-            size_t pos ;
-            while ((pos = partialData.find('\n')) != std::string::npos ){
-                // copy a complete message to our string to parse, then erase that portion from our data string.
-                std::string jsonStr = partialData.substr(0,pos); 
-                partialData.erase(0, pos + 1); 
+        // requests are small and latency sensitive
+        int one = 1 ;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
 
-                // handle the parsed json string
-                handleClientMessage(sock, jsonStr);
+        auto conn = std::make_shared<Connection>(sock);
+        conn->inbox.resize(INBOX_INITIAL_SIZE);
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex_);
+            connections_[sock] = conn ;
+        }
+
+        epoll_event ev{} ;
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET ;
+        ev.data.fd = sock ;
+        if ( epoll_ctl(epollFd_, EPOLL_CTL_ADD, sock, &ev) < 0 ){
+            perror("epoll_ctl");
+            closeConnection(conn);
+            continue ;
+        }
+        SPDLOG_INFO("client connected (fd {})", sock);
+    }
+}
+
+void ApiHandler::onReadable(const std::shared_ptr<Connection>& conn){
+    // not read while a request runs on the worker pool, resumeConnections picks it up again
+    if ( conn->closing || conn->busy ) return ;
+
+    // edge triggered, so drain the socket completely, handling messages whenever the inbox fills up
+    bool drained = false ;
+    bool peerClosed = false ;
+    while ( !drained && !conn->busy && !conn->closing ){
+        while ( conn->inboxEnd - conn->inboxStart < INBOX_MAX_PENDING ){
+            // compact once the unparsed tail is small compared to what was consumed, then grow
+            if ( conn->inboxEnd == conn->inbox.size() ){
+                size_t pending = conn->inboxEnd - conn->inboxStart ;
+                if ( conn->inboxStart > 0 && pending <= conn->inboxStart ){
+                    std::memmove(conn->inbox.data(), conn->inbox.data() + conn->inboxStart, pending);
+                    conn->inboxStart = 0 ;
+                    conn->inboxEnd = pending ;
+                } else {
+                    conn->inbox.resize(conn->inbox.size() * 2);
+                }
             }
-        } else if (bytesReceived == 0){
-            break ;
-        } else {
-            if (errno == EAGAIN || errno == EWOULDBLOCK ){
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+            size_t space = std::min(conn->inbox.size() - conn->inboxEnd, INBOX_MAX_PENDING - (conn->inboxEnd - conn->inboxStart));
+            ssize_t n = recv(conn->fd, conn->inbox.data() + conn->inboxEnd, space, 0);
+            if ( n > 0 ){
+                conn->inboxEnd += n ;
                 continue ;
-            } else {
+            }
+            if ( n == 0 ){
+                peerClosed = true ;
+            } else if ( errno == EINTR ){
+                continue ;
+            } else if ( errno != EAGAIN && errno != EWOULDBLOCK ){
                 perror("recv");
+                peerClosed = true ;
+            }
+            drained = true ;
+            break ;
+        }
+
+        processInbox(conn);
+
+        // whatever is left unparsed after processing can't be completed within the inbox
+        if ( !conn->busy && !conn->closing && conn->inboxEnd - conn->inboxStart >= INBOX_MAX_PENDING ){
+            SPDLOG_ERROR("dropping client connection: inbox overflow, {} bytes pending without a complete message", INBOX_MAX_PENDING);
+            closeConnection(conn);
+            return ;
+        }
+    }
+
+    if ( peerClosed && !conn->closing ){
+        closeConnection(conn);
+    }
+}
+
+void ApiHandler::processInbox(const std::shared_ptr<Connection>& conn){
+    std::string_view payload ;
+    size_t consumed ;
+
+    // stop at a deferred request so that later messages keep their order
+    while ( !conn->busy && !conn->closing ){
+        try {
+            if ( !extractMessage(conn->inbox.data() + conn->inboxStart, conn->inboxEnd - conn->inboxStart,
+                                 conn->format, payload, consumed) ){
                 break ;
             }
+        } catch (const std::exception& e){
+            SPDLOG_ERROR("dropping client connection: {}", e.what());
+            closeConnection(conn);
+            return ;
         }
+        conn->inboxStart += consumed ;
+        handleClientMessage(conn->fd, payload);
+    }
+
+    // leave further input in the socket until the deferred request is done
+    if ( conn->busy && !conn->closing ) setReading(conn, false);
+
+    if ( conn->inboxStart == conn->inboxEnd ){
+        conn->inboxStart = 0 ;
+        conn->inboxEnd = 0 ;
+    }
+}
+
+void ApiHandler::onWritable(const std::shared_ptr<Connection>& conn){
+    std::lock_guard<std::mutex> lock(conn->outMutex);
+    while ( conn->outboxStart < conn->outbox.size() ){
+        ssize_t n = send(conn->fd, conn->outbox.data() + conn->outboxStart, conn->outbox.size() - conn->outboxStart, MSG_NOSIGNAL);
+        if ( n < 0 ){
+            if ( errno == EINTR ) continue ;
+            if ( errno != EAGAIN && errno != EWOULDBLOCK ) perror("send");
+            return ;
+        }
+        conn->outboxStart += n ;
+    }
+    conn->outbox.clear();
+    conn->outboxStart = 0 ;
+
+    if ( conn->wantWrite ){
+        conn->wantWrite = false ;
+        updateInterest(*conn);
+    }
+}
+
+void ApiHandler::queueOutput(int sock, const std::string& data){
+    auto conn = getConnection(sock);
+    if ( !conn ) return ;
+
+    std::lock_guard<std::mutex> lock(conn->outMutex);
+    size_t sent = 0 ;
+
+    // write straight to the socket unless earlier output is still waiting
+    if ( conn->outboxStart == conn->outbox.size() ){
+        while ( sent < data.size() ){
+            ssize_t n = send(sock, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if ( n < 0 ){
+                if ( errno == EINTR ) continue ;
+                if ( errno != EAGAIN && errno != EWOULDBLOCK ){
+                    perror("send");
+                    return ;
+                }
+                break ;
+            }
+            sent += n ;
+        }
+        if ( sent == data.size() ) return ;
+    }
+
+    conn->outbox.append(data, sent, std::string::npos);
+    if ( !conn->wantWrite ){
+        conn->wantWrite = true ;
+        updateInterest(*conn);
+    }
+}
+
+void ApiHandler::setReading(const std::shared_ptr<Connection>& conn, bool reading){
+    std::lock_guard<std::mutex> lock(conn->outMutex);
+    if ( conn->reading == reading ) return ;
+    conn->reading = reading ;
+    updateInterest(*conn);
+}
+
+// re-register the events the connection waits for, outMutex held
+void ApiHandler::updateInterest(Connection& conn){
+    epoll_event ev{} ;
+    ev.events = EPOLLRDHUP | EPOLLET ;
+    if ( conn.reading ) ev.events |= EPOLLIN ;
+    if ( conn.wantWrite ) ev.events |= EPOLLOUT ;
+    ev.data.fd = conn.fd ;
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+void ApiHandler::closeConnection(const std::shared_ptr<Connection>& conn){
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, conn->fd, nullptr);
+    subscriptions_->removeClient(conn->fd);
+    updateSubscriptionTimer();
+
+    // keep the fd reserved until the worker has sent its response
+    if ( conn->busy ){
+        conn->closing = true ;
+        return ;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(connectionsMutex_);
+        auto it = connections_.find(conn->fd);
+        if ( it == connections_.end() || it->second != conn ) return ;
+        connections_.erase(it);
+    }
+    conn->closing = true ; // callers further up the stack stop reading
+    close(conn->fd);
+    SPDLOG_INFO("client disconnected (fd {})", conn->fd);
+}
+
+void ApiHandler::resumeConnections(){
+    std::vector<int> resumed ;
+    {
+        std::lock_guard<std::mutex> lock(resumedMutex_);
+        resumed.swap(resumed_);
+    }
+
+    for ( int fd : resumed ){
+        auto conn = getConnection(fd);
+        if ( !conn ) continue ;
+        conn->busy = false ;
+        if ( conn->closing ){
+            conn->closing = false ;
+            closeConnection(conn);
+            continue ;
+        }
+        processInbox(conn);
+        if ( conn->busy || conn->closing ) continue ;
+
+        // read what arrived meanwhile, the edge for it may already have passed
+        setReading(conn, true);
+        onReadable(conn);
+    }
+}
+
+void ApiHandler::updateSubscriptionTimer(){
+    if ( timerFd_ < 0 ) return ;
+
+    // only tick while someone is subscribed
+    itimerspec spec{} ;
+    if ( !subscriptions_->empty() ){
+        spec.it_interval.tv_nsec = SUBSCRIPTION_TICK_NS ;
+        spec.it_value.tv_nsec = SUBSCRIPTION_TICK_NS ;
+    }
+    timerfd_settime(timerFd_, 0, &spec, nullptr);
+}
+
+void ApiHandler::sendSubscriptionUpdates(){
+    for ( auto& [sock, message] : subscriptions_->poll(SubscriptionManager::Clock::now()) ){
+        queueOutput(sock, encodeMessage(message, getWireFormat(sock)));
+    }
+}
+
+std::shared_ptr<ApiHandler::Connection> ApiHandler::getConnection(int sock) const {
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    auto it = connections_.find(sock);
+    return it == connections_.end() ? nullptr : it->second ;
+}
+
+void ApiHandler::startWorkers(){
+    for ( size_t i = 0 ; i < N_WORKERS ; ++i ){
+        workers_.emplace_back(&ApiHandler::workerLoop, this);
+    }
+}
+
+void ApiHandler::stopWorkers(){
+    taskCv_.notify_all();
+    for ( auto& w : workers_ ){
+        if ( w.joinable() ) w.join();
+    }
+    workers_.clear();
+}
+
+void ApiHandler::workerLoop(){
+    Tracer::setThreadName("api worker");
+    while (true){
+        std::function<void()> task ;
+        {
+            std::unique_lock<std::mutex> lock(taskMutex_);
+            taskCv_.wait(lock, [this]{ return stopping_ || !tasks_.empty(); });
+            if ( tasks_.empty() ) return ;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        TRACE_SCOPE("api_worker_task");
+        task();
+    }
+}
+
+WireFormat ApiHandler::getWireFormat(int sock) const {
+    auto conn = getConnection(sock);
+    return conn ? conn->format.load() : WireFormat::JSON ;
+}
+
+void ApiHandler::setWireFormat(int sock, WireFormat format){
+    auto conn = getConnection(sock);
+    if ( conn ) conn->format = format ;
+}
+
+bool ApiHandler::extractMessage(const char* data, size_t size, WireFormat format, std::string_view& payload, size_t& consumed){
+    if ( format == WireFormat::JSON ){
+        const char* end = static_cast<const char*>(std::memchr(data, '\n', size));
+        if ( !end ) return false ;
+        payload = std::string_view(data, end - data);
+        consumed = payload.size() + 1 ;
+        return true ;
+    }
+
+    if ( size < WIRE_FRAME_HEADER_SIZE ) return false ;
+    uint32_t frameSize = readFrameHeader(data);
+    if ( frameSize > WIRE_MAX_FRAME_SIZE ){
+        throw std::runtime_error("frame of " + std::to_string(frameSize) + " bytes exceeds the maximum frame size");
     }
+    if ( size < WIRE_FRAME_HEADER_SIZE + frameSize ) return false ;
+    payload = std::string_view(data + WIRE_FRAME_HEADER_SIZE, frameSize);
+    consumed = WIRE_FRAME_HEADER_SIZE + frameSize ;
+    return true ;
+}
 
-    close(sock);
+json ApiHandler::decodeMessage(std::string_view payload, WireFormat format){
+    switch(format){
+    case WireFormat::MSGPACK:
+        return json::from_msgpack(payload.begin(), payload.end());
+    case WireFormat::CBOR:
+        return json::from_cbor(payload.begin(), payload.end());
+    default:
+        return json::parse(payload.begin(), payload.end());
+    }
+}
+
+std::string ApiHandler::encodeMessage(const json& message, WireFormat format){
+    if ( format == WireFormat::JSON ){
+        return message.dump() + '\n' ;
+    }
+
+    std::string frame(WIRE_FRAME_HEADER_SIZE, '\0');
+    if ( format == WireFormat::MSGPACK ){
+        json::to_msgpack(message, frame);
+    } else {
+        json::to_cbor(message, frame);
+    }
+    writeFrameHeader(static_cast<uint32_t>(frame.size() - WIRE_FRAME_HEADER_SIZE), frame.data());
+    return frame ;
 }
 
 json ApiHandler::sendApiResponse(int sock, json& response, const std::string& err){
@@ -196,36 +598,88 @@ json ApiHandler::sendApiResponse(int sock, json& response, const std::string& er
         response["error"] = err ;
         SPDLOG_ERROR("Api Request Failed: {}", err);
     }
-    std::string r = response.dump() + '\n' ;
-    SPDLOG_INFO("sending API response: {}", r.c_str());
-    send(sock, r.c_str(), r.size(), 0);
+    if ( sock == NO_SOCKET ) return response ;
+
+    // dumping large responses is expensive, only done when the api logs at debug
+    LOG_AT(LogSubsystem::API, spdlog::level::debug, "sending API response: {}", response.dump());
+
+    queueOutput(sock, encodeMessage(response, getWireFormat(sock)));
     return response ;
 }
 
 
-void ApiHandler::handleClientMessage(int sock, std::string jsonStr){
+json ApiHandler::handleRequest(const json& request){
+    json response = request ;
+    std::string action = request.value("action", "");
+
+    auto it = handlers_.find(action);
+    if ( it == handlers_.end() ){
+        return sendApiResponse(NO_SOCKET, response, "unknown action requested: " + action );
+    }
+    return it->second(NO_SOCKET, request);
+}
+
+void ApiHandler::handleClientMessage(int sock, std::string_view payload){
+    TRACE_SCOPE("api_request");
     json request;
     std::string action ;
 
-    SPDLOG_INFO("received request: {}", jsonStr);
-
     try {
-        request = json::parse(jsonStr);
+        request = decodeMessage(payload, getWireFormat(sock));
         action = request["action"];
     } catch (const std::exception& e){
-        sendApiResponse(sock,request, "Error parsing json request: " + std::string(e.what()));
+        sendApiResponse(sock,request, "Error parsing request: " + std::string(e.what()));
         return ;
     }
+
+    LOG_AT(LogSubsystem::API, spdlog::level::debug, "received request: {}", request.dump());
     
     auto it = handlers_.find(action);
     if ( it == handlers_.end() ){
         sendApiResponse(sock, request, "unknown action requested: " + action );
         return ;
     }
+
+    // long-running requests go to the worker pool, the connection holds its remaining
+    // messages until the response has been queued
+    auto conn = getConnection(sock);
+    if ( conn && workerActions_.count(action) ){
+        conn->busy = true ;
+        std::lock_guard<std::mutex> lock(taskMutex_);
+        tasks_.emplace_back([this, sock, request = std::move(request), &handler = it->second](){
+            handler(sock, request);
+            {
+                std::lock_guard<std::mutex> lock(resumedMutex_);
+                resumed_.push_back(sock);
+            }
+            wake();
+        });
+        taskCv_.notify_one();
+        return ;
+    }
     
     it->second(sock, request);
 }
 
+json ApiHandler::setProtocol(int sock, const json& request){
+    json response = request ;
+    WireFormat format ;
+
+    try {
+        format = wireFormatFromString(request.at("format").get<std::string>());
+    } catch (const std::exception& e){
+        return sendApiResponse(sock, response, "Error parsing json request: " + std::string(e.what()));
+    }
+
+    // reply in the current format, then switch both directions
+    sendApiResponse(sock, response);
+    if ( sock != NO_SOCKET ){
+        setWireFormat(sock, format);
+        SPDLOG_INFO("client switched to {} wire format", wireFormat2String(format));
+    }
+    return response ;
+}
+
 json ApiHandler::getAudioDevices(int sock, const json& request){
     json response = request ;
     response["data"] = engine_->getAvailableAudioDevices() ;
@@ -256,6 +710,23 @@ json ApiHandler::setAudioDevice(int sock, const json& request){
     }
 }
 
+json ApiHandler::setBufferSize(int sock, const json& request){
+    json response = request ;
+    unsigned int frames ;
+
+    try {
+        frames = response["buffer_size"];
+    } catch (const std::exception& e){
+        return sendApiResponse(sock,response, "Error parsing json request: " + std::string(e.what()) );
+    }
+
+    if ( engine_->setBufferSize(frames) ){
+        return sendApiResponse(sock,response);
+    } else {
+        return sendApiResponse(sock, response, "failed to set buffer size");
+    }
+}
+
 json ApiHandler::setMidiDevice(int sock, const json& request){
     json response = request ;
     int deviceId ;
@@ -296,6 +767,211 @@ json ApiHandler::setState(int sock, const json& request){
     return sendApiResponse(sock,response, "Unrecognized engine state requested: " + state);
 }
 
+json ApiHandler::getSharedMemory(int sock, const json& request){
+    json response = request ;
+    const SharedParameterTable& table = engine_->sharedParameters ;
+    if ( !table.isOpen() ){
+        return sendApiResponse(sock, response, "shared memory control is disabled");
+    }
+
+    response["data"] = {
+        {"name", table.getName()},
+        {"version", SharedParameterLayout::VERSION},
+        {"maxComponents", SharedParameterLayout::MAX_COMPONENTS},
+        {"nParameters", N_PARAMETER_TYPES}
+    };
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::getProcessingPlan(int sock, const json& request){
+    json response = request ;
+    response["data"] = engine_->signalController.describePlan();
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::getEngineStats(int sock, const json& request){
+    json response = request ;
+    response["data"] = engine_->engineStats.describe();
+    response["data"]["realtimeViolations"] = RtCheck::report();
+    if ( response.value("reset", false) ){
+        engine_->engineStats.reset();
+    }
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::getModuleStats(int sock, const json& request){
+    json response = request ;
+    const ModuleProfiler& profiler = engine_->moduleProfiler ;
+    uint64_t window = profiler.getLastWindow() ;
+    double sampleRate = engine_->getSampleRate() ;
+
+    // loads from an older window belong to components that are no longer scheduled
+    json components = json::object();
+    engine_->componentManager.forEach([&](BaseComponent* c){
+        const ComponentProfile& profile = c->getProfile() ;
+        bool current = window > 0 && profile.published.load(std::memory_order_relaxed) == window ;
+        double process = current ? profile.processLoad.load(std::memory_order_relaxed) : 0.0 ;
+        double modulation = current ? profile.modulationLoad.load(std::memory_order_relaxed) : 0.0 ;
+        components[std::to_string(c->getId())] = {
+            {"type", c->getType()},
+            {"processLoad", process},
+            {"modulationLoad", modulation},
+            {"processNsPerSample", process * 1e9 / sampleRate},
+            {"modulationNsPerSample", modulation * 1e9 / sampleRate}
+        };
+    });
+
+    response["data"] = {
+        {"enabled", profiler.isEnabled()},
+        {"window", window},
+        {"windowSeconds", ModuleProfiler::WINDOW_SECONDS},
+        {"components", components}
+    };
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::setModuleProfiling(int sock, const json& request){
+    json response = request ;
+    bool enabled ;
+
+    try {
+        enabled = response["enabled"];
+    } catch (const std::exception& e){
+        return sendApiResponse(sock,response, "Error parsing json request: " + std::string(e.what()) );
+    }
+
+    engine_->moduleProfiler.setEnabled(enabled);
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::setTracing(int sock, const json& request){
+    json response = request ;
+    bool enabled ;
+    std::string file ;
+
+    try {
+        enabled = response["enabled"];
+        file = response.value("file", "synth_trace.json");
+    } catch (const std::exception& e){
+        return sendApiResponse(sock,response, "Error parsing json request: " + std::string(e.what()) );
+    }
+
+    // clients name a file, where it goes is up to the engine's config
+    if ( enabled && !Tracer::isFileName(file) ){
+        return sendApiResponse(sock, response, "trace file must be a plain file name: " + file);
+    }
+
+    Tracer* tracer = Tracer::instance();
+    bool ok = enabled ? tracer->start(file) : tracer->stop() ;
+    response["data"] = tracer->status();
+    if ( !ok ){
+        return sendApiResponse(sock, response, enabled ? "failed to start tracing" : "failed to write trace");
+    }
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::getLatencyStats(int sock, const json& request){
+    json response = request ;
+    response["data"] = engine_->latencyProbe.describe();
+    if ( response.value("reset", false) ){
+        engine_->latencyProbe.reset();
+    }
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::setLogLevel(int sock, const json& request){
+    json response = request ;
+    std::string subsystem ;
+    std::string level ;
+
+    try {
+        level = response["level"];
+        subsystem = response.value("subsystem", "");
+    } catch (const std::exception& e){
+        return sendApiResponse(sock,response, "Error parsing json request: " + std::string(e.what()) );
+    }
+
+    auto parsedLevel = Log::levelFromString(level);
+    if ( !parsedLevel ){
+        return sendApiResponse(sock, response, "unknown log level: " + level);
+    }
+
+    // without a subsystem every level is set
+    if ( subsystem.empty() ){
+        for ( size_t i = 0 ; i < Log::N_SUBSYSTEMS ; ++i ){
+            Log::setLevel(static_cast<LogSubsystem>(i), *parsedLevel);
+        }
+    } else if ( auto parsed = Log::subsystemFromString(subsystem) ){
+        Log::setLevel(*parsed, *parsedLevel);
+    } else {
+        return sendApiResponse(sock, response, "unknown log subsystem: " + subsystem);
+    }
+
+    response["data"] = Log::instance()->status();
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::getRealtimeStatus(int sock, const json& request){
+    json response = request ;
+    response["data"] = engine_->realtimeMode.status();
+    response["data"]["planBuffersLocked"] = engine_->signalController.describePlan()["buffers"]["locked"] ;
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::getGovernorStatus(int sock, const json& request){
+    json response = request ;
+    response["data"] = engine_->governor.status();
+    response["data"]["stolenVoices"] = engine_->signalController.getStolenVoices() ;
+
+    json optional = json::array();
+    for ( ComponentId id : engine_->componentManager.getModuleIds() ){
+        BaseModule* m = engine_->componentManager.getModule(id);
+        if ( m && m->isOptional() ) optional.push_back(id);
+    }
+    response["data"]["optionalComponents"] = optional ;
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::setGovernor(int sock, const json& request){
+    json response = request ;
+    bool enabled ;
+
+    try {
+        enabled = response["enabled"];
+    } catch (const std::exception& e){
+        return sendApiResponse(sock,response, "Error parsing json request: " + std::string(e.what()) );
+    }
+
+    engine_->governor.setEnabled(enabled);
+    response["data"] = engine_->governor.status();
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::setComponentOptional(int sock, const json& request){
+    json response = request ;
+    ComponentId id ;
+    bool optional ;
+
+    try {
+        id = response["componentId"];
+        optional = response["optional"];
+    } catch (const std::exception& e){
+        return sendApiResponse(sock,response, "Error parsing json request: " + std::string(e.what()) );
+    }
+
+    BaseModule* m = engine_->componentManager.getModule(id);
+    if ( !m ){
+        return sendApiResponse(sock, response, "component is not a signal module.");
+    }
+    // a generator has no input to pass through, skipping it would only silence it
+    if ( optional && m->isGenerative() ){
+        return sendApiResponse(sock, response, "generators cannot be optional.");
+    }
+
+    m->setOptional(optional);
+    return sendApiResponse(sock, response);
+}
+
 json ApiHandler::getConfiguration(int sock, const json& request){
     json response = request ;
     response["data"] = engine_->serialize();
@@ -313,19 +989,29 @@ json ApiHandler::loadConfiguration(int sock, const json& request){
         return sendApiResponse(sock, response, "Error processing json request " + std::string(e.what()));
     }
 
+    auto start = std::chrono::steady_clock::now();
     std::unordered_map<int,int> idMap ;
-    if ( ! loadCreateComponent(sock,response["components"], idMap) ){
-        return sendApiResponse(sock, response, "Error creating components");
-    }
+    {
+        // saved parameter values land at a single block boundary
+        ParameterChangeQueue::Batch batch(engine_->parameterQueue);
+        // the processing plan is built once, after every connection is in place
+        SignalController::BulkUpdate bulk(engine_->signalController);
+
+        if ( ! loadCreateComponent(sock,response["components"], idMap) ){
+            return sendApiResponse(sock, response, "Error creating components");
+        }
 
-    // update response data with new component ids
-    loadUpdateIds(response, idMap);
+        // update response data with new component ids
+        loadUpdateIds(response, idMap);
 
-    // connect components
-    if ( ! loadConnectComponent(sock, response) ){
-        return sendApiResponse(sock, response, "Error connecting components");
+        // connect components
+        if ( ! loadConnectComponent(sock, response) ){
+            return sendApiResponse(sock, response, "Error connecting components");
+        }
     }
 
+    response["loadTimeMs"] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    SPDLOG_INFO("configuration loaded in {:.2f} ms", response["loadTimeMs"].get<double>());
     return sendApiResponse(sock, response);
 }
 
@@ -342,6 +1028,9 @@ json ApiHandler::addComponent(int sock, const json& request){
     }
 
     ComponentId id = engine_->componentFactory.createFromJson(type, name, getDefaultConfig(type));
+    // shared memory writes to the id from before it was handed out are not meant for it
+    engine_->sharedParameters.discard(id);
+    engine_->signalController.updateProcessingGraph();
     response["componentId"] = id;
     return sendApiResponse(sock,response);
 }
@@ -361,6 +1050,15 @@ json ApiHandler::removeComponent(int sock, const json& request){
         return sendApiResponse(sock, response, "component not found.");
     }
 
+    if ( !disconnectComponent(sock, id) ){
+        return sendApiResponse(sock, response, "at least one component connection could not be removed.");
+    }
+
+    deleteComponent(id);
+    return sendApiResponse(sock, response);    
+}
+
+bool ApiHandler::disconnectComponent(int sock, ComponentId id){
     // query each subsystem and remove connections, if exist
     bool allRemoved = true ;
 
@@ -395,12 +1093,21 @@ json ApiHandler::removeComponent(int sock, const json& request){
         allRemoved = allRemoved && cresponse.contains("status") && cresponse["status"] == "success" ;
     }
 
-    if ( !allRemoved ){
-        return sendApiResponse(sock, response, "at least one component connection could not be removed.");
-    }
+    return allRemoved ;
+}
 
-    engine_->componentManager.remove(id);
-    return sendApiResponse(sock, response);    
+void ApiHandler::deleteComponent(ComponentId id){
+    // make sure the audio thread no longer samples the component before deleting it
+    subscriptions_->removeComponent(id);
+    std::unique_ptr<BaseComponent> component = engine_->componentManager.detach(id);
+    if ( BaseModule* module = dynamic_cast<BaseModule*>(component.get()) ){
+        engine_->signalController.removeModule(module);
+    } else {
+        engine_->signalController.updateProcessingGraph();
+    }
+    engine_->signalController.flush();
+    engine_->parameterQueue.waitForBlock();
+    engine_->sharedParameters.discard(id);
 }
 
 
@@ -419,7 +1126,11 @@ json ApiHandler::parseConnectionRequest(int sock, const json& request){
     }
 
     if ( routeConnectionRequest(req)){
+        if ( !req.remove && engine_->isFeedbackConnection(req) ) response["feedback"] = true ;
+        response["planGeneration"] = engine_->signalController.getGeneration();
         return sendApiResponse(sock,response);
+    } else if ( engine_->connectionCreatesCycle(req) ){
+        return sendApiResponse(sock,response, "connection would create a cycle");
     } else {
         return sendApiResponse(sock,response, "failed to handle requested connection event");
     }
@@ -463,14 +1174,26 @@ json ApiHandler::setParameter(int sock, const json& request){
     if ( !c ){
         return sendApiResponse(sock, response, "Component not found");
     }
+    std::string offsetError = validateFrameOffset(request);
+    if ( !offsetError.empty() ){
+        return sendApiResponse(sock, response, offsetError);
+    }
 
-    bool setSuccess = c->getParameters()->setValueDispatch(param, response["value"]);
-    response["value"] = c->getParameters()->getValueDispatch(param); // feed the value back to the client (due to limiting or other behaviors)
-    if ( setSuccess ){
-        return sendApiResponse(sock,response);
-    } else {
-        return sendApiResponse(sock,response, "Error setting component parameter." );
+    ParameterChange change{ ParameterChangeType::VALUE, param, id, 0, 0.0 };
+    if ( !request.value("smooth", true) ) change.type = ParameterChangeType::JUMP ;
+    try {
+        // feed the value back to the client (due to limiting or other behaviors)
+        response["value"] = c->getParameters()->limitValueDispatch(param, response["value"]);
+        change.value = response["value"].is_boolean() ? response["value"].get<bool>() : response["value"].get<double>() ;
+        change.frameOffset = request.value("frameOffset", 0u);
+    } catch (const std::exception& e){
+        return sendApiResponse(sock, response, "Error setting component parameter: " + std::string(e.what()) );
+    }
+
+    if ( !engine_->parameterQueue.submit(change) ){
+        return sendApiResponse(sock, response, "Parameter queue is full, try again." );
     }
+    return sendApiResponse(sock,response);
 }
 
 json ApiHandler::getParameterDefault(int sock, const json& request){
@@ -589,9 +1312,18 @@ json ApiHandler::resetParameter(int sock, const json& request){
         return sendApiResponse(sock, response, "Component not found");
     }
 
-    response["minimum"] = c->getParameters()->getMinDispatch(param);
-    response["maximum"] = c->getParameters()->getMaxDispatch(param);
+    // queued like any other value change, so it lands in order with them
+    ParameterChange change{ ParameterChangeType::VALUE, param, id, 0, 0.0 };
+    try {
+        response["value"] = c->getParameters()->getDefaultDispatch(param);
+        change.value = response["value"].is_boolean() ? response["value"].get<bool>() : response["value"].get<double>() ;
+    } catch (const std::exception& e){
+        return sendApiResponse(sock, response, "Error resetting component parameter: " + std::string(e.what()) );
+    }
 
+    if ( !engine_->parameterQueue.submit(change) ){
+        return sendApiResponse(sock, response, "Parameter queue is full, try again." );
+    }
     return sendApiResponse(sock, response);
 }
 
@@ -914,7 +1646,15 @@ json ApiHandler::setModulationStrategy(int sock, const json& request){
         );
     }
 
-    component->setParameterModulationStrategy(p, s);
+    std::string offsetError = validateFrameOffset(request);
+    if ( !offsetError.empty() ){
+        return sendApiResponse(sock, response, offsetError);
+    }
+
+    ParameterChange change{ ParameterChangeType::STRATEGY, p, id, request.value("frameOffset", 0u), static_cast<double>(s) };
+    if ( !engine_->parameterQueue.submit(change) ){
+        return sendApiResponse(sock, response, "Parameter queue is full, try again." );
+    }
     return sendApiResponse(sock, response);
 }
 
@@ -998,10 +1738,573 @@ json ApiHandler::setModulationDepth(int sock, const json& request){
         );
     }
 
-    component->setParameterDepth(p, depth);
+    std::string offsetError = validateFrameOffset(request);
+    if ( !offsetError.empty() ){
+        return sendApiResponse(sock, response, offsetError);
+    }
+
+    ParameterChange change{ ParameterChangeType::DEPTH, p, id, request.value("frameOffset", 0u), depth };
+    if ( !engine_->parameterQueue.submit(change) ){
+        return sendApiResponse(sock, response, "Parameter queue is full, try again." );
+    }
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::subscribe(int sock, const json& request){
+    json response = request ;
+    double rate ;
+    std::vector<std::pair<ProbeKey, BaseComponent*>> keys ;
+
+    try {
+        rate = request.at("rate").get<double>();
+        for ( const auto& k : request.at("keys") ){
+            ProbeKey key ;
+            key.componentId = k.at("componentId").get<ComponentId>();
+            if ( k.contains("parameter") ){
+                key.kind = ProbeKind::PARAMETER ;
+                key.parameter = parameterFromString(k["parameter"].get<std::string>());
+            } else {
+                std::string metric = k.at("metric").get<std::string>();
+                if ( metric == "level" ) key.kind = ProbeKind::LEVEL ;
+                else if ( metric == "rms" ) key.kind = ProbeKind::RMS ;
+                else if ( metric == "voices" ) key.kind = ProbeKind::VOICES ;
+                else throw std::invalid_argument("unknown metric " + metric);
+                key.output = k.value("output", 0);
+            }
+            keys.emplace_back(key, engine_->componentManager.getRaw(key.componentId));
+        }
+    } catch (const std::exception& e){
+        return sendApiResponse(sock, response, "Error parsing json request: " + std::string(e.what()));
+    }
+
+    std::string err ;
+    int id = subscriptions_->subscribe(sock, rate, keys, err);
+    if ( id < 0 ){
+        return sendApiResponse(sock, response, err);
+    }
+    updateSubscriptionTimer();
+
+    response["subscriptionId"] = id ;
+    return sendApiResponse(sock, response);
+}
+
+json ApiHandler::unsubscribe(int sock, const json& request){
+    json response = request ;
+    int id ;
+
+    try {
+        id = request.at("subscriptionId").get<int>();
+    } catch (const std::exception& e){
+        return sendApiResponse(sock, response, "Error parsing json request: " + std::string(e.what()));
+    }
+
+    if ( !subscriptions_->unsubscribe(sock, id) ){
+        return sendApiResponse(sock, response, "subscription not found");
+    }
+    updateSubscriptionTimer();
     return sendApiResponse(sock, response);
 }
 
+json ApiHandler::applyBatch(int sock, const json& request){
+    json response ;
+    response["action"] = "batch" ;
+    if ( request.contains("id") ) response["id"] = request["id"] ; // optional client correlation id
+
+    if ( !request.contains("requests") || !request["requests"].is_array() ){
+        return sendApiResponse(sock, response, "batch request requires a 'requests' array");
+    }
+    const json& requests = request["requests"] ;
+
+    /*
+    Components added by the batch are referred to as {"ref": <index of the add_component
+    request>} wherever a component id is expected. Every sub-request is validated before any
+    is applied; those with references only once the ids they refer to are known.
+    */
+    std::unordered_set<ComponentId> removed ;
+    std::vector<bool> deferred(requests.size(), false);
+    for ( size_t i = 0 ; i < requests.size() ; ++i ){
+        std::string err = validateBatchAction(requests[i]);
+        if ( err.empty() ) err = validateBatchReferences(requests, i);
+        if ( err.empty() ){
+            deferred[i] = hasBatchReferences(requests[i]);
+            if ( !deferred[i] ) err = validateBatchRequest(requests[i], removed);
+        }
+        if ( err.empty() ) err = validateBatchOrder(requests, i);
+        if ( !err.empty() ){
+            return sendApiResponse(sock, response, fmt::format("request {}: {}", i, err));
+        }
+    }
+
+    /*
+    The batch is applied in request order, and every edit can be taken back: graph and direct
+    edits record how to revert them, and queued parameter changes stay in the batch until it
+    ends. If any request fails, everything applied so far is undone. Removed components are
+    disconnected in order, and only deleted once nothing can roll back anymore.
+    */
+    json results = json::array();
+    for ( size_t i = 0 ; i < requests.size() ; ++i ) results.push_back(json::object());
+    bool rolledBack = false ;
+    {
+        ParameterChangeQueue::Batch batch(engine_->parameterQueue);
+        SignalController::BulkUpdate bulk(engine_->signalController);
+        std::vector<std::function<void()>> undo ;
+        std::vector<ComponentId> removals ;
+        std::vector<ComponentId> added(requests.size(), -1); // by index of the add_component request
+        removed.clear();
+
+        for ( size_t i = 0 ; i < requests.size() ; ++i ){
+            json resolved ;
+            if ( deferred[i] ) resolved = resolveBatchReferences(requests[i], added);
+            const json& sub = deferred[i] ? resolved : requests[i] ;
+            const std::string& action = sub["action"].get_ref<const std::string&>();
+
+            std::string err = deferred[i] ? validateBatchRequest(sub, removed) : "" ;
+            if ( !err.empty() ){
+                results[i] = {{"status", "failed"}, {"error", err}};
+                rollbackBatch(undo);
+                batch.cancel();
+                rolledBack = true ;
+                break ;
+            }
+            if ( action == "remove_component" ) removed.insert(sub["componentId"].get<ComponentId>());
+
+            std::vector<ComponentId> touched ;
+            if ( action.ends_with("_connection") ) touched = getConnectionEndpoints(sub);
+            if ( action == "remove_component" ) touched = {sub["componentId"].get<ComponentId>()};
+            std::vector<ConnectionRequest> before = getConnections(touched);
+            std::function<void()> revert = checkpointBatchRequest(sub);
+
+            json r ;
+            if ( action == "remove_component" ){
+                json removal = sub ;
+                ComponentId id = sub["componentId"] ;
+                if ( disconnectComponent(NO_SOCKET, id) ){
+                    removals.push_back(id);
+                    r = sendApiResponse(NO_SOCKET, removal);
+                } else {
+                    r = sendApiResponse(NO_SOCKET, removal, "at least one component connection could not be removed.");
+                }
+            } else {
+                r = handlers_.at(action)(NO_SOCKET, sub);
+            }
+            bool ok = r.value("status", "") == "success" ;
+
+            // only report what the client doesn't already know, resolved references included
+            json result = json::object();
+            for ( const auto& [key, value] : r.items() ){
+                if ( key == "action" ) continue ;
+                if ( !requests[i].contains(key) || requests[i][key] != value ) result[key] = value ;
+            }
+            results[i] = result ;
+
+            if ( !ok ){
+                // whatever the failed request did apply is taken back along with the rest
+                if ( !touched.empty() ) undo.push_back(revertConnections(before, getConnections(touched)));
+                if ( revert ) undo.push_back(std::move(revert));
+                rollbackBatch(undo);
+                batch.cancel();
+                rolledBack = true ;
+                break ;
+            }
+
+            if ( action == "add_component" ){
+                added[i] = r["componentId"] ;
+                json inverse = {{"action", "remove_component"}, {"componentId", r["componentId"]}};
+                undo.push_back([this, inverse](){ revertBatchRequest(inverse); });
+            } else if ( !touched.empty() ){
+                undo.push_back(revertConnections(before, getConnections(touched)));
+            } else if ( revert ){
+                undo.push_back(std::move(revert));
+            }
+        }
+
+        if ( !rolledBack ){
+            for ( ComponentId id : removals ) deleteComponent(id);
+        }
+    }
+
+    response["results"] = results ;
+    if ( rolledBack ){
+        size_t nFailed = 0 ;
+        for ( auto& result : results ){
+            if ( result.value("status", "") == "failed" ){
+                ++nFailed ;
+                continue ;
+            }
+            result = {{"status", "failed"}, {"error", "not applied, the batch was rolled back"}};
+        }
+        return sendApiResponse(sock, response, fmt::format("{} of {} batched requests failed, no changes were applied", nFailed, requests.size()));
+    }
+    return sendApiResponse(sock, response);
+}
+
+void ApiHandler::rollbackBatch(const std::vector<std::function<void()>>& undo){
+    for ( auto it = undo.rbegin() ; it != undo.rend() ; ++it ) (*it)();
+}
+
+void ApiHandler::revertBatchRequest(const json& inverse){
+    json r = handlers_.at(inverse["action"])(NO_SOCKET, inverse);
+    if ( r.value("status", "") != "success" ){
+        SPDLOG_ERROR("could not roll back batched edit: {}", inverse.dump());
+    }
+}
+
+std::function<void()> ApiHandler::revertConnections(const std::vector<ConnectionRequest>& before, const std::vector<ConnectionRequest>& after){
+    // the connections that appeared are removed again, those that went away come back
+    json inverse = json::array();
+    for ( ConnectionRequest c : after ){
+        if ( std::find(before.begin(), before.end(), c) != before.end() ) continue ;
+        c.remove = true ;
+        inverse.push_back(c);
+    }
+    for ( ConnectionRequest c : before ){
+        if ( std::find(after.begin(), after.end(), c) != after.end() ) continue ;
+        c.remove = false ;
+        inverse.push_back(c);
+    }
+    return [this, inverse](){
+        for ( const json& r : inverse ) revertBatchRequest(r);
+    };
+}
+
+std::function<void()> ApiHandler::checkpointBatchRequest(const json& request){
+    const std::string& action = request["action"].get_ref<const std::string&>();
+    if ( action.starts_with("get_") || isQueuedBatchAction(action) || !request.contains("componentId") ) return {} ;
+
+    BaseComponent* c = engine_->componentManager.getRaw(request["componentId"].get<ComponentId>());
+    if ( !c ) return {} ;
+    json inverse = {{"action", action}, {"componentId", c->getId()}};
+
+    try {
+        if ( action == "set_parameter_default" ){
+            ParameterType p = static_cast<ParameterType>(request.at("parameter"));
+            inverse["parameter"] = p ;
+            inverse["value"] = c->getParameters()->getDefaultDispatch(p);
+        } else if ( action == "set_parameter_range" ){
+            ParameterType p = static_cast<ParameterType>(request.at("parameter"));
+            inverse["parameter"] = p ;
+            inverse["minimum"] = c->getParameters()->getMinDispatch(p);
+            inverse["maximum"] = c->getParameters()->getMaxDispatch(p);
+        } else if ( action == "set_component_optional" ){
+            BaseModule* m = engine_->componentManager.getModule(c->getId());
+            if ( !m ) return {} ;
+            inverse["optional"] = m->isOptional();
+        } else if ( action.find("collection") != std::string::npos ){
+            // collection edits are undone by restoring every collection they may touch
+            const CollectionDescriptor& cd = getCollectionDescriptor(c->getType(), CollectionType(request.at("collection")));
+            std::vector<std::function<void()>> restore ;
+            for ( ParameterType p : cd.params ){
+                if ( ParameterCollectionBase* collection = c->getParameters()->getCollection(p) ){
+                    restore.push_back(collection->checkpoint());
+                }
+            }
+            return [restore](){
+                for ( const auto& r : restore ) r();
+            };
+        } else {
+            return {} ;
+        }
+    } catch ( const std::exception& e ){
+        return {} ; // the request fails the same way when it is applied
+    }
+
+    return [this, inverse](){ revertBatchRequest(inverse); };
+}
+
+bool ApiHandler::isQueuedBatchAction(const std::string& action) const {
+    return action == "set_parameter" || action == "reset_parameter" ||
+        action == "set_modulation_strategy" || action == "set_modulation_depth" ;
+}
+
+/*
+queued parameter changes land when the batch ends, after everything else in it. A request
+that reads or re-ranges a parameter a queued change was submitted for earlier in the batch
+would see it out of order, so the batch is rejected instead.
+*/
+std::string ApiHandler::validateBatchOrder(const json& requests, size_t index) const {
+    const json& request = requests[index] ;
+    const std::string& action = request["action"].get_ref<const std::string&>();
+
+    bool readsParameter = action == "get_parameter" || action == "set_parameter_range" ||
+        action == "get_modulation_strategy" || action == "get_modulation_depth" ;
+    if ( !readsParameter && action != "get_configuration" ) return "" ;
+
+    std::optional<ParameterType> parameter = readsParameter ? getBatchParameter(request) : std::nullopt ;
+    for ( size_t i = 0 ; i < index ; ++i ){
+        const json& earlier = requests[i] ;
+        if ( !isQueuedBatchAction(earlier["action"].get_ref<const std::string&>()) ) continue ;
+        if ( action == "get_configuration" ){
+            return fmt::format("reads parameters before the change queued by request {} is applied", i);
+        }
+        if ( earlier["componentId"] == request["componentId"] && getBatchParameter(earlier) == parameter ){
+            return fmt::format("reads the parameter before the change queued by request {} is applied", i);
+        }
+    }
+    return "" ;
+}
+
+// parameters are given by value, except by the modulation actions which name them
+std::optional<ParameterType> ApiHandler::getBatchParameter(const json& request) const {
+    try {
+        const json& p = request.at("parameter");
+        if ( p.is_string() ) return parameterFromString(p);
+        return static_cast<ParameterType>(p.get<int>());
+    } catch ( const std::exception& e ){
+        return std::nullopt ;
+    }
+}
+
+std::vector<ComponentId> ApiHandler::getConnectionEndpoints(const json& request) const {
+    ConnectionRequest req = request.get<ConnectionRequest>();
+    std::vector<ComponentId> ids ;
+    if ( req.inboundID.has_value() ) ids.push_back(*req.inboundID);
+    if ( req.outboundID.has_value() ) ids.push_back(*req.outboundID);
+
+    // a new modulator replaces the parameter's current one
+    if ( req.inboundSocket == SocketType::ModulationInbound && req.inboundID.has_value() ){
+        if ( BaseComponent* c = engine_->componentManager.getRaw(*req.inboundID) ){
+            ParameterType p = req.inboundParameter.value();
+            BaseModulator* current = req.depthConnection ? c->getParameterDepthModulator(p) : c->getParameterModulator(p);
+            if ( current ) ids.push_back(current->getId());
+        }
+    }
+    return ids ;
+}
+
+std::vector<ConnectionRequest> ApiHandler::getConnections(const std::vector<ComponentId>& ids) const {
+    std::vector<ConnectionRequest> connections ;
+    auto add = [&connections](const std::vector<ConnectionRequest>& found){
+        for ( const auto& c : found ){
+            if ( std::find(connections.begin(), connections.end(), c) == connections.end() ) connections.push_back(c);
+        }
+    };
+    for ( ComponentId id : ids ){
+        add(engine_->getComponentMidiConnections(id));
+        add(engine_->getComponentSignalConnections(id));
+        add(engine_->getComponentModulationConnections(id));
+    }
+    return connections ;
+}
+
+std::string ApiHandler::validateBatchAction(const json& request) const {
+    if ( !request.is_object() ) return "not a json object" ;
+    if ( !request.contains("action") || !request["action"].is_string() ) return "missing action" ;
+
+    const std::string& action = request["action"].get_ref<const std::string&>();
+    if ( action == "batch" ) return "batches cannot be nested" ;
+    // long running actions open their own batch (load_configuration) or restart the stream
+    if ( workerActions_.count(action) || action == "set_protocol" || action == "subscribe" || action == "unsubscribe" ){
+        return "action " + action + " cannot be batched" ;
+    }
+    // engine settings, not patch edits, and a batch must be able to take back everything it applied
+    if ( action == "set_module_profiling" || action == "set_log_level" || action == "set_governor" ){
+        return "action " + action + " cannot be batched" ;
+    }
+    if ( handlers_.find(action) == handlers_.end() ) return "unknown action requested: " + action ;
+    return "" ;
+}
+
+std::string ApiHandler::validateBatchRequest(const json& request, std::unordered_set<ComponentId>& removed) const {
+    std::string err = validateBatchAction(request);
+    if ( !err.empty() ) return err ;
+
+    const std::string& action = request["action"].get_ref<const std::string&>();
+    BaseComponent* c = nullptr ;
+    if ( request.contains("componentId") ){
+        if ( !request["componentId"].is_number_integer() ) return "componentId is not an integer" ;
+        ComponentId id = request["componentId"] ;
+        if ( removed.count(id) ) return "component is removed earlier in the batch" ;
+        c = engine_->componentManager.getRaw(id);
+        if ( !c ) return "component not found" ;
+    }
+
+    try {
+        if ( action == "add_component" ){
+            int type = request.at("type");
+            if ( type < 0 || type >= N_COMPONENT_TYPES ) return "unknown component type" ;
+            if ( !request.at("name").is_string() ) return "name is not a string" ;
+            return "" ;
+        }
+
+        if ( action.ends_with("_connection") ){
+            return validateBatchConnection(request, removed);
+        }
+
+        if ( action.find("collection") != std::string::npos ){
+            if ( !c ) return "missing componentId" ;
+            const CollectionDescriptor& cd = getCollectionDescriptor(c->getType(), CollectionType(request.at("collection")));
+            if ( !cd.isValid() ) return "collection descriptor is malformed" ;
+            CollectionRequest req = request ;
+            if ( !req.valid(cd) ) return "invalid collection request structure" ;
+            if ( req.action == CollectionAction::REMOVE || req.action == CollectionAction::GET || req.action == CollectionAction::SET ){
+                c->getParameters()->getCollectionValueDispatch(cd.params[0], *req.index); // throws if the index is not in use
+            }
+            return "" ;
+        }
+
+        if ( action.find("modulation") != std::string::npos ){
+            if ( !c ) return "missing componentId" ;
+            ParameterType p = parameterFromString(request.at("parameter"));
+            const auto& modulatable = ComponentRegistry::getComponentDescriptor(c->getType()).modulatableParameters ;
+            if ( std::find(modulatable.begin(), modulatable.end(), p) == modulatable.end() ){
+                return "parameter " + GET_PARAMETER_TRAIT_MEMBER(p, name) + " is not modulatable for this component" ;
+            }
+            if ( action == "set_modulation_strategy" ){
+                int strategy = request.at("strategy");
+                if ( strategy < 0 || strategy >= static_cast<int>(ModulationStrategy::N_STRATEGIES) ) return "unknown modulation strategy" ;
+            }
+            if ( action == "set_modulation_depth" && !request.at("depth").is_number() ) return "depth is not a number" ;
+            return validateFrameOffset(request);
+        }
+
+        if ( action.find("parameter") != std::string::npos ){
+            if ( !c ) return "missing componentId" ;
+            int raw = request.at("parameter");
+            if ( raw < 0 || raw >= N_PARAMETER_TYPES ) return "unknown parameter" ;
+            ParameterType p = static_cast<ParameterType>(raw);
+            if ( !c->getParameters()->getParameter(p) ) return "component has no parameter " + GET_PARAMETER_TRAIT_MEMBER(p, name) ;
+
+            if ( action == "set_parameter" ){
+                c->getParameters()->limitValueDispatch(p, request.at("value"));
+                if ( request.contains("smooth") && !request["smooth"].is_boolean() ) return "smooth is not a boolean" ;
+                std::string offsetError = validateFrameOffset(request);
+                if ( !offsetError.empty() ) return offsetError ;
+            }
+            if ( action == "set_parameter_default" ){
+                const json& value = request.at("value");
+                if ( !value.is_number() && !value.is_boolean() ) return "value is not a number" ;
+            }
+            if ( action == "set_parameter_range" ){
+                const json& minimum = request.at("minimum");
+                const json& maximum = request.at("maximum");
+                if ( !minimum.is_number() || !maximum.is_number() ) return "range is not numeric" ;
+                if ( minimum.get<double>() > maximum.get<double>() ) return "minimum is above maximum" ;
+            }
+            return "" ;
+        }
+    } catch ( const std::exception& e ){
+        return "Error parsing json request: " + std::string(e.what()) ;
+    }
+
+    if ( action == "remove_component" ){
+        if ( !c ) return "missing componentId" ;
+        removed.insert(c->getId());
+    }
+    
+    return "" ;
+}
+
+// where a sub-request may name a component, by json pointer
+static const std::array<json::json_pointer, 3> COMPONENT_ID_FIELDS = {
+    json::json_pointer("/componentId"),
+    json::json_pointer("/inbound/componentId"),
+    json::json_pointer("/outbound/componentId")
+};
+
+static bool isBatchReference(const json& id){
+    return id.is_object() && id.contains("ref");
+}
+
+bool ApiHandler::hasBatchReferences(const json& request) const {
+    for ( const auto& field : COMPONENT_ID_FIELDS ){
+        if ( request.contains(field) && isBatchReference(request[field]) ) return true ;
+    }
+    return false ;
+}
+
+std::string ApiHandler::validateBatchReferences(const json& requests, size_t index) const {
+    for ( const auto& field : COMPONENT_ID_FIELDS ){
+        if ( !requests[index].contains(field) || !requests[index][field].is_object() ) continue ;
+        const json& id = requests[index][field] ;
+        if ( id.size() != 1 || !id.contains("ref") || !id["ref"].is_number_integer() || id["ref"].get<int64_t>() < 0 ){
+            return field.to_string() + " reference is not {\"ref\": <request index>}" ;
+        }
+        size_t ref = id["ref"] ;
+        if ( ref >= index ) return field.to_string() + " refers to a request that is not before it" ;
+        if ( requests[ref]["action"] != "add_component" ) return field.to_string() + " refers to a request that adds no component" ;
+    }
+    return "" ;
+}
+
+json ApiHandler::resolveBatchReferences(const json& request, const std::vector<ComponentId>& added) const {
+    json resolved = request ;
+    for ( const auto& field : COMPONENT_ID_FIELDS ){
+        if ( resolved.contains(field) && isBatchReference(resolved[field]) ){
+            resolved[field] = added[resolved[field]["ref"].get<size_t>()] ;
+        }
+    }
+    return resolved ;
+}
+
+std::string ApiHandler::validateFrameOffset(const json& request) const {
+    if ( !request.contains("frameOffset") ) return "" ;
+    const json& offset = request["frameOffset"] ;
+    // json built in code holds non-negative numbers as signed integers, parsed json as unsigned ones
+    if ( !offset.is_number_integer() || offset.get<int64_t>() < 0 ) return "frameOffset is not an unsigned integer" ;
+    if ( offset.get<int64_t>() > ParameterChangeQueue::MAX_FRAME_OFFSET ){
+        return "frameOffset is more than " + std::to_string(ParameterChangeQueue::MAX_FRAME_OFFSET) + " frames ahead" ;
+    }
+    return "" ;
+}
+
+std::string ApiHandler::validateBatchConnection(const json& request, const std::unordered_set<ComponentId>& removed) const {
+    ConnectionRequest req = request.get<ConnectionRequest>();
+    if ( !req.valid() ) return "invalid connection request" ;
+
+    BaseComponent* inbound = nullptr ;
+    BaseComponent* outbound = nullptr ;
+    if ( req.inboundID.has_value() ){
+        if ( removed.count(*req.inboundID) ) return "inbound component is removed earlier in the batch" ;
+        inbound = engine_->componentManager.getRaw(*req.inboundID);
+        if ( !inbound ) return "inbound component not found" ;
+    }
+    if ( req.outboundID.has_value() ){
+        if ( removed.count(*req.outboundID) ) return "outbound component is removed earlier in the batch" ;
+        outbound = engine_->componentManager.getRaw(*req.outboundID);
+        if ( !outbound ) return "outbound component not found" ;
+    }
+
+    switch ( req.inboundSocket ){
+    case SocketType::SignalInbound:
+    {
+        BaseModule* from = engine_->componentManager.getModule(req.outboundID.value_or(-1));
+        if ( !from ) return "signal source is not a module" ;
+        if ( *req.outboundIdx >= from->getNumOutputs() ) return "signal source has no output " + std::to_string(*req.outboundIdx) ;
+        if ( inbound ){
+            BaseModule* to = engine_->componentManager.getModule(*req.inboundID);
+            if ( !to ) return "signal destination is not a module" ;
+            if ( *req.inboundIdx >= to->getNumInputs() ) return "signal destination has no input " + std::to_string(*req.inboundIdx) ;
+        }
+        return "" ;
+    }
+    case SocketType::MidiInbound:
+    {
+        if ( !inbound ) return "midi connections need an inbound component" ;
+        const auto& inDescriptor = ComponentRegistry::getComponentDescriptor(inbound->getType());
+        if ( outbound ){
+            if ( !engine_->componentManager.getMidiHandler(*req.outboundID) ) return "outbound component does not handle midi" ;
+            if ( !inDescriptor.isMidiListener() ) return "inbound component does not listen to midi" ;
+        } else if ( !inDescriptor.isMidiHandler() && !inDescriptor.isMidiListener() ){
+            return "inbound component does not handle midi" ;
+        }
+        return "" ;
+    }
+    case SocketType::ModulationInbound:
+    {
+        if ( !inbound || !outbound ) return "modulation connections need both components" ;
+        if ( !engine_->componentManager.getModulator(*req.outboundID) ) return "outbound component is not a modulator" ;
+        const auto& modulatable = ComponentRegistry::getComponentDescriptor(inbound->getType()).modulatableParameters ;
+        if ( std::find(modulatable.begin(), modulatable.end(), *req.inboundParameter) == modulatable.end() ){
+            return "parameter is not modulatable for the inbound component" ;
+        }
+        if ( engine_->connectionCreatesCycle(req) ) return "connection would create a cycle" ;
+        return "" ;
+    }
+    default:
+        return "invalid connection request" ;
+    }
+}
+
 bool ApiHandler::routeConnectionRequest(ConnectionRequest request){
     if ( request.inboundSocket == SocketType::MidiInbound && request.outboundSocket == SocketType::MidiOutbound )
         return engine_->handleMidiConnection(request);
@@ -1045,8 +2348,14 @@ bool ApiHandler::loadCreateComponent(int sock, const json& components, std::unor
                 parameterRequest["componentId"] = idMap[id] ;
                 parameterRequest["parameter"] = static_cast<int>(parameterType);
                 parameterRequest["value"] = data.at("currentValue") ;
+                parameterRequest["smooth"] = false ; // new components start at their saved values
                 setParameter(sock, parameterRequest);
             }
+
+            if ( component.value("optional", false) ){
+                json optionalRequest = {{"action", "set_component_optional"}, {"componentId", idMap[id]}, {"optional", true}};
+                setComponentOptional(sock, optionalRequest);
+            }
         } catch ( const std::exception& e ){
             SPDLOG_WARN("Error creating component: {}", std::string(e.what()));
             success = false ;
@@ -1110,7 +2419,8 @@ bool ApiHandler::loadConnectComponent(int sock, const json& config){
         }
     }
 
-    // intercomponent connections
+    // intercomponent connections. Feedback edges go in last so they close the same cycles as when saved
+    std::vector<ConnectionRequest> feedbackConnections ;
     if ( config.contains("components") && config.at("components").is_array() ){
         for ( const auto& component : config.at("components") ){
             if (
@@ -1149,6 +2459,10 @@ bool ApiHandler::loadConnectComponent(int sock, const json& config){
                         req.outboundID = outbound.at("componentId");
                         req.outboundIdx = outbound.at("index");
                         req.outboundSocket = SocketType::SignalOutbound ;
+                        if ( outbound.value("feedback", false) ){
+                            feedbackConnections.push_back(req);
+                            continue ;
+                        }
 
                         const auto& connectionResponse = parseConnectionRequest(sock, req);
                         if ( ! connectionResponse.contains("status") || connectionResponse.at("status") != "success" ){
@@ -1216,6 +2530,14 @@ bool ApiHandler::loadConnectComponent(int sock, const json& config){
         }
     }
 
+    for ( const auto& req : feedbackConnections ){
+        const auto& connectionResponse = parseConnectionRequest(sock, req);
+        if ( ! connectionResponse.contains("status") || connectionResponse.at("status") != "success" ){
+            SPDLOG_ERROR("error requesting connection: {}", connectionResponse.dump());
+            success = false ;
+        }
+    }
+
     return success ;
 
 }
@@ -19,13 +19,25 @@
 #define __API_HANDLER_HPP_
 
 #include <nlohmann/json.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "core/BaseComponent.hpp"
 #include "meta/CollectionDescriptor.hpp"
 #include "requests/ConnectionRequest.hpp"
 #include "requests/CollectionRequest.hpp"
 #include "params/ParameterMap.hpp"
+#include "api/SubscriptionManager.hpp"
+#include "types/WireFormat.hpp"
 
 
 using json = nlohmann::json ;
@@ -39,8 +51,54 @@ private:
     Engine* engine_ ;
     std::unordered_map<std::string, HandlerFunc> handlers_ ;
 
+    // per-client state. Only the event loop reads into the inbox; responses may be
+    // queued from worker threads, so the outbox is guarded by its own mutex.
+    struct Connection {
+        int fd ;
+        std::vector<char> inbox ;
+        size_t inboxStart = 0 ; // offset cursor of the first unparsed byte
+        size_t inboxEnd = 0 ;
+        std::string outbox ;
+        size_t outboxStart = 0 ;
+        bool wantWrite = false ;
+        bool reading = true ;  // EPOLLIN is armed, dropped while busy so the socket pushes back
+        std::mutex outMutex ;  // also guards wantWrite, reading and the epoll registration
+        std::atomic<WireFormat> format{WireFormat::JSON} ; // negotiated encoding
+        bool busy = false ;    // a request is running on the worker pool; later messages wait
+        bool closing = false ; // closed, or peer went away while busy and closed once the worker is done
+
+        explicit Connection(int sock): fd(sock){}
+    };
+    static constexpr size_t INBOX_INITIAL_SIZE = 4096 ;
+    static constexpr size_t INBOX_MAX_PENDING = WIRE_FRAME_HEADER_SIZE + WIRE_MAX_FRAME_SIZE ; // largest message plus framing
+
+    std::unordered_map<int, std::shared_ptr<Connection>> connections_ ;
+    mutable std::mutex connectionsMutex_ ;
+
+    int epollFd_ = -1 ;
+    std::atomic<int> wakeFd_{-1} ; // eventfd used for shutdown and worker completions
+    std::atomic<bool> stopping_{false} ;
+    int timerFd_ = -1 ;            // drives subscription updates while any exist
+    std::vector<int> resumed_ ;    // connections whose deferred request finished
+    std::mutex resumedMutex_ ;
+
+    std::unique_ptr<SubscriptionManager> subscriptions_ ;
+    static constexpr long SUBSCRIPTION_TICK_NS = 5000000 ;
+
+    // small worker pool for requests that would stall the event loop
+    static constexpr size_t N_WORKERS = 2 ;
+    std::unordered_set<std::string> workerActions_ ;
+    std::vector<std::thread> workers_ ;
+    std::deque<std::function<void()>> tasks_ ;
+    std::mutex taskMutex_ ;
+    std::condition_variable taskCv_ ;
+
     ApiHandler();
 
+public:
+    static constexpr int NO_SOCKET = -1 ; // build responses without sending them (e.g., batched sub-requests)
+
+
 public:
     static ApiHandler* instance() ;
     ApiHandler(const ApiHandler&) = delete ;
@@ -51,10 +109,41 @@ public:
     void initialize(Engine* engine);
 
     void start();
-    void onClientConnection(int clientSock);
-    void handleClientMessage(int clientSock, std::string jsonStr);
+    void stop(); // async-signal-safe
+    void handleClientMessage(int clientSock, std::string_view payload);
     json sendApiResponse(int clientSock, json& response, const std::string& err = "");
 
+    // apply a request on the calling thread and return the response, no client involved
+    json handleRequest(const json& request);
+
+private:
+    // event loop
+    void acceptConnections(int serverSock);
+    void onReadable(const std::shared_ptr<Connection>& conn);
+    void onWritable(const std::shared_ptr<Connection>& conn);
+    void processInbox(const std::shared_ptr<Connection>& conn);
+    void closeConnection(const std::shared_ptr<Connection>& conn);
+    void resumeConnections();
+    void setReading(const std::shared_ptr<Connection>& conn, bool reading);
+    void updateInterest(Connection& conn);
+    std::shared_ptr<Connection> getConnection(int sock) const ;
+    void queueOutput(int sock, const std::string& data);
+    void updateSubscriptionTimer();
+    void sendSubscriptionUpdates();
+    void wake();
+
+    // worker pool
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop();
+
+    // wire format negotiation and framing
+    WireFormat getWireFormat(int sock) const ;
+    void setWireFormat(int sock, WireFormat format);
+    static bool extractMessage(const char* data, size_t size, WireFormat format, std::string_view& payload, size_t& consumed);
+    static json decodeMessage(std::string_view payload, WireFormat format);
+    static std::string encodeMessage(const json& message, WireFormat format);
+
 private:
     /*
     ---------------------------------------------------------
@@ -62,17 +151,33 @@ private:
     ---------------------------------------------------------
     */
     // engine management
+    json setProtocol(int sock, const json& request);
     json getAudioDevices(int sock, const json& request);
     json getMidiDevices(int sock, const json& request);
     json setAudioDevice(int sock, const json& request);
     json setMidiDevice(int sock, const json& request);
+    json setBufferSize(int sock, const json& request);
     json setState(int sock, const json& request);
+    json getSharedMemory(int sock, const json& request);
+    json getProcessingPlan(int sock, const json& request);
+    json getEngineStats(int sock, const json& request);
+    json getModuleStats(int sock, const json& request);
+    json setModuleProfiling(int sock, const json& request);
+    json setTracing(int sock, const json& request);
+    json getLatencyStats(int sock, const json& request);
+    json setLogLevel(int sock, const json& request);
+    json getRealtimeStatus(int sock, const json& request);
+    json getGovernorStatus(int sock, const json& request);
+    json setGovernor(int sock, const json& request);
+    json setComponentOptional(int sock, const json& request);
     // api save/load
     json getConfiguration(int sock, const json& request);
     json loadConfiguration(int sock, const json& request);
     // component management
     json addComponent(int sock, const json& request);
     json removeComponent(int sock, const json& request);
+    bool disconnectComponent(int sock, ComponentId id);
+    void deleteComponent(ComponentId id);
     json parseConnectionRequest(int sock, const json& request);
     bool routeConnectionRequest(ConnectionRequest request);
     
@@ -97,6 +202,27 @@ private:
     json setModulationStrategy(int sock, const json& request);
     json getModulationDepth(int sock, const json& request);
     json setModulationDepth(int sock, const json& request);
+    // subscriptions
+    json subscribe(int sock, const json& request);
+    json unsubscribe(int sock, const json& request);
+    // batching
+    json applyBatch(int sock, const json& request);
+    void rollbackBatch(const std::vector<std::function<void()>>& undo);
+    void revertBatchRequest(const json& inverse);
+    std::function<void()> revertConnections(const std::vector<ConnectionRequest>& before, const std::vector<ConnectionRequest>& after);
+    std::function<void()> checkpointBatchRequest(const json& request);
+    bool isQueuedBatchAction(const std::string& action) const ;
+    std::string validateBatchOrder(const json& requests, size_t index) const ;
+    std::optional<ParameterType> getBatchParameter(const json& request) const ;
+    std::string validateBatchAction(const json& request) const ;
+    std::string validateBatchRequest(const json& request, std::unordered_set<ComponentId>& removed) const ;
+    std::string validateBatchReferences(const json& requests, size_t index) const ;
+    bool hasBatchReferences(const json& request) const ;
+    json resolveBatchReferences(const json& request, const std::vector<ComponentId>& added) const ;
+    std::string validateBatchConnection(const json& request, const std::unordered_set<ComponentId>& removed) const ;
+    std::vector<ComponentId> getConnectionEndpoints(const json& request) const ;
+    std::string validateFrameOffset(const json& request) const ;
+    std::vector<ConnectionRequest> getConnections(const std::vector<ComponentId>& ids) const ;
     
     // load functions
     bool loadCreateComponent(int sock, const json& components, std::unordered_map<int,int>& idMap);
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "api/SubscriptionManager.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+SubscriptionManager::SubscriptionManager(ProbeTable* probes):
+    probes_(probes)
+{}
+
+SubscriptionManager::~SubscriptionManager(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    for ( auto& [id, sub] : subscriptions_ ) release(sub);
+}
+
+int SubscriptionManager::subscribe(int sock, double rate, const std::vector<std::pair<ProbeKey, BaseComponent*>>& keys, std::string& err){
+    if ( keys.empty() ){
+        err = "no keys requested" ;
+        return -1 ;
+    }
+    if ( keys.size() > MAX_KEYS ){
+        err = "too many keys requested (maximum " + std::to_string(MAX_KEYS) + ")" ;
+        return -1 ;
+    }
+    if ( !(rate >= MIN_RATE && rate <= MAX_RATE) ){
+        err = "rate must be between " + std::to_string(MIN_RATE) + " and " + std::to_string(MAX_RATE) ;
+        return -1 ;
+    }
+
+    Subscription sub ;
+    sub.sock = sock ;
+    sub.period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    sub.due = Clock::now();
+    sub.entries.reserve(keys.size());
+
+    for ( size_t i = 0 ; i < keys.size() ; ++i ){
+        auto probe = probes_->acquire(keys[i].first, keys[i].second);
+        if ( !probe ){
+            release(sub);
+            err = "key " + std::to_string(i) + " is not available on component " + std::to_string(keys[i].first.componentId) ;
+            return -1 ;
+        }
+        sub.entries.push_back({probe});
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    int id = nextId_++ ;
+    subscriptions_.emplace(id, std::move(sub));
+    return id ;
+}
+
+bool SubscriptionManager::unsubscribe(int sock, int id){
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = subscriptions_.find(id);
+    if ( it == subscriptions_.end() || it->second.sock != sock ) return false ;
+    release(it->second);
+    subscriptions_.erase(it);
+    return true ;
+}
+
+void SubscriptionManager::removeClient(int sock){
+    std::lock_guard<std::mutex> lock(mutex_);
+    for ( auto it = subscriptions_.begin() ; it != subscriptions_.end() ; ){
+        if ( it->second.sock == sock ){
+            release(it->second);
+            it = subscriptions_.erase(it);
+        } else {
+            ++it ;
+        }
+    }
+}
+
+void SubscriptionManager::removeComponent(ComponentId id){
+    std::lock_guard<std::mutex> lock(mutex_);
+    for ( auto& [subId, sub] : subscriptions_ ){
+        for ( auto& entry : sub.entries ){
+            if ( entry.probe && entry.probe->key.componentId == id ){
+                probes_->release(entry.probe);
+                entry.probe = nullptr ;
+            }
+        }
+    }
+}
+
+bool SubscriptionManager::empty(){
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscriptions_.empty();
+}
+
+std::vector<std::pair<int, json>> SubscriptionManager::poll(Clock::time_point now){
+    std::vector<std::pair<int, json>> updates ;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for ( auto& [id, sub] : subscriptions_ ){
+        if ( now < sub.due ) continue ;
+        // don't try to catch up on missed updates, just keep the rate
+        sub.due = std::max(sub.due + sub.period, now);
+
+        json values = json::array();
+        for ( size_t i = 0 ; i < sub.entries.size() ; ++i ){
+            Entry& entry = sub.entries[i] ;
+            if ( !entry.probe ) continue ;
+            float value = entry.probe->value.load(std::memory_order_relaxed);
+            if ( entry.sent && !changed(entry.last, value) ) continue ;
+            entry.last = value ;
+            entry.sent = true ;
+            values.push_back({i, value});
+        }
+        if ( values.empty() ) continue ;
+
+        updates.emplace_back(sub.sock, json{
+            {"action", "subscription_update"},
+            {"subscriptionId", id},
+            {"values", std::move(values)}
+        });
+    }
+    return updates ;
+}
+
+void SubscriptionManager::release(Subscription& sub){
+    for ( auto& entry : sub.entries ){
+        if ( entry.probe ) probes_->release(entry.probe);
+        entry.probe = nullptr ;
+    }
+}
+
+bool SubscriptionManager::changed(float last, float value){
+    return std::fabs(value - last) > 1e-5f * std::max(1.0f, std::fabs(last)) ;
+}
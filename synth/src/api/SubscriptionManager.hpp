@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SUBSCRIPTION_MANAGER_HPP_
+#define __SUBSCRIPTION_MANAGER_HPP_
+
+#include "core/ProbeTable.hpp"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+/**
+ * @brief client subscriptions to live engine values
+ * 
+ * A subscription is a list of probe keys and an update rate. Values are read from the
+ * engine's ProbeTable (written once per audio block) and only keys that changed since
+ * the last update are pushed, as [index, value] pairs into the subscribed key list.
+ */
+class SubscriptionManager {
+public:
+    static constexpr double MIN_RATE = 0.5 ;   // updates per second
+    static constexpr double MAX_RATE = 120.0 ;
+    static constexpr size_t MAX_KEYS = 1024 ;
+
+    using Clock = std::chrono::steady_clock ;
+
+private:
+    struct Entry {
+        std::shared_ptr<Probe> probe ; // null once the component is removed
+        float last = 0.0f ;
+        bool sent = false ;
+    };
+
+    struct Subscription {
+        int sock ;
+        Clock::duration period ;
+        Clock::time_point due ;
+        std::vector<Entry> entries ;
+    };
+
+    ProbeTable* probes_ ;
+    std::mutex mutex_ ;
+    std::map<int, Subscription> subscriptions_ ;
+    int nextId_ = 0 ;
+
+public:
+    SubscriptionManager(ProbeTable* probes);
+    ~SubscriptionManager();
+
+    /**
+     * @brief register a subscription for the client
+     * 
+     * @param keys probe keys, with the component they refer to
+     * @return subscription id, or -1 with err set
+     */
+    int subscribe(int sock, double rate, const std::vector<std::pair<ProbeKey, BaseComponent*>>& keys, std::string& err);
+    bool unsubscribe(int sock, int id);
+    void removeClient(int sock);
+
+    // drop every probe of the component. The audio thread stops reading it after one block
+    void removeComponent(ComponentId id);
+
+    bool empty();
+
+    /**
+     * @brief collect the updates that are due
+     * 
+     * @return (socket, message) pairs to send
+     */
+    std::vector<std::pair<int, json>> poll(Clock::time_point now);
+
+private:
+    void release(Subscription& sub);
+    static bool changed(float last, float value);
+};
+
+#endif // __SUBSCRIPTION_MANAGER_HPP_
@@ -11,7 +11,10 @@ BiquadFilter::BiquadFilter(ComponentId id, BiquadFilterConfig cfg):
     BaseModulator(),
     state1_(0.0),
     state2_(0.0),
-    dirty_(false)
+    tailFrames_(TAIL_UNKNOWN),
+    dirty_(false),
+    coefficientInterval_(1),
+    sinceUpdate_(0)
 {
     parameters_->add<ParameterType::FILTER_TYPE>(cfg.filterType, false);
     parameters_->add<ParameterType::FREQUENCY>(cfg.frequency, true);
@@ -129,6 +132,39 @@ void BiquadFilter::calculateCoefficients(){
 
     // normalize coefficients:
     coefficients_ = {b0/a0, b1/a0, b2/a0, a1/a0, a2/a0};
+    calculateTail();
+}
+
+// frames for the impulse response to fall 100dB, from the largest pole radius
+void BiquadFilter::calculateTail(){
+    double a1 = coefficients_[3] ;
+    double a2 = coefficients_[4] ;
+    double disc = a1 * a1 - 4.0 * a2 ;
+
+    double radius ;
+    if ( disc < 0.0 ){
+        radius = std::sqrt(a2);
+    } else {
+        double root = std::sqrt(disc);
+        radius = std::max(std::fabs(-a1 + root), std::fabs(-a1 - root)) / 2.0 ;
+    }
+
+    if ( radius >= 1.0 ){
+        tailFrames_ = TAIL_UNKNOWN ;
+    } else if ( radius <= 0.0 ){
+        tailFrames_ = 2 ;
+    } else {
+        tailFrames_ = static_cast<size_t>(std::ceil(std::log(1e-5) / std::log(radius))) + 2 ;
+    }
+}
+
+size_t BiquadFilter::getTailFrames() const {
+    return tailFrames_ ;
+}
+
+void BiquadFilter::resetTail(){
+    state1_ = 0.0 ;
+    state2_ = 0.0 ;
 }
 
 inline double BiquadFilter::getCurrentOutput(double input){
@@ -175,12 +211,18 @@ void BiquadFilter::calculateSample(){
 
 void BiquadFilter::tick(){
     BaseModule::tick();
-    if ( dirty_ ){
+    if ( ++sinceUpdate_ >= coefficientInterval_ && dirty_ ){
         calculateCoefficients();
         dirty_ = false ;
+        sinceUpdate_ = 0 ;
     }
 }
 
+// a modulated filter otherwise recomputes its coefficients every frame
+void BiquadFilter::setCoefficientInterval(size_t frames){
+    coefficientInterval_ = std::max<size_t>(frames, 1);
+}
+
 void BiquadFilter::onParameterChanged([[maybe_unused]] ParameterType p){
     dirty_ = true ;
 } 
@@ -27,8 +27,11 @@ private:
     double state1_ ;
     double state2_ ;
     std::array<double,5> coefficients_ ;
+    size_t tailFrames_ ;
 
     bool dirty_ ;
+    size_t coefficientInterval_ ; // frames between coefficient updates
+    size_t sinceUpdate_ ;
 public:
     BiquadFilter(ComponentId id, BiquadFilterConfig cfg);
 
@@ -36,10 +39,14 @@ public:
 
     void calculateSample() override ;
     void tick() override ;
+    size_t getTailFrames() const override ;
+    void resetTail() override ;
+    void setCoefficientInterval(size_t frames) override ;
     void onParameterChanged(ParameterType p) override ;
 
 private:
     void calculateCoefficients();
+    void calculateTail();
     inline double getCurrentOutput(double input);
     inline double getCurrentOutput(double input, double& s1, double& s2) const ;
 
@@ -37,4 +37,13 @@ void Delay::calculateSample(){
     double gain = parameters_->getParameter<ParameterType::GAIN>()->getInstantaneousValue() ;
 
     setBufferValue(0, delay_.read(delay) * gain) ;
-}
\ No newline at end of file
+}
+
+size_t Delay::getTailFrames() const {
+    // whatever delay is set when the module wakes up, the line must have flushed by then
+    return delay_.capacity() ;
+}
+
+void Delay::resetTail(){
+    delay_.clear();
+}
@@ -30,6 +30,8 @@ public:
     Delay(ComponentId id, DelayConfig cfg);
 
     void calculateSample() override ;
+    size_t getTailFrames() const override ;
+    void resetTail() override ;
 };
 
 #endif // DELAY_HPP_
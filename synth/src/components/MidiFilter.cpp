@@ -24,12 +24,12 @@ void MidiFilter::onKeyReleased(ActiveNote anote){
 }
 
 bool MidiFilter::passNote(uint8_t midi) const {
-    auto c = parameters_->getCollection<ParameterType::MIDI_VALUE>();
+    const auto& c = parameters_->getCollection<ParameterType::MIDI_VALUE>()->snapshot();
     bool passNote = true ;
-    for ( size_t i = 0 ; i < c->size() - 1 ; i += 2 ){
+    for ( size_t i = 0 ; i < c.size() - 1 ; i += 2 ){
         passNote = passNote 
-            && midi >= c->getValue(i)
-            && midi <= c->getValue(i+1);
+            && midi >= c.getValue(i)
+            && midi <= c.getValue(i+1);
         if ( !passNote ) break ;
     }
     return passNote ;
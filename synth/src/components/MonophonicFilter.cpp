@@ -17,9 +17,9 @@
 
 #include "components/MonophonicFilter.hpp"
 #include "midi/MidiEventHandler.hpp"
-#include <spdlog/spdlog.h>
-#include <fmt/ranges.h>
-#include <ranges>
+#include "diagnostics/Log.hpp"
+
+#include <algorithm>
 
 MonophonicFilter::MonophonicFilter(ComponentId id, [[maybe_unused]] MonophonicFilterConfig cfg):
     BaseComponent(id, ComponentType::MonophonicFilter)
@@ -27,20 +27,17 @@ MonophonicFilter::MonophonicFilter(ComponentId id, [[maybe_unused]] MonophonicFi
 
 void MonophonicFilter::onKeyPressed(const ActiveNote* note, bool rePressed){
     uint8_t midiNote = note->note.getMidiNote() ;
-    SPDLOG_DEBUG("received note press event for midiNote {}.", midiNote);
+    LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "received note press event for midiNote {}.", midiNote);
     noteStack_.push_back(midiNote);
-    SPDLOG_DEBUG("current noteStack_: {}", fmt::format("{}", fmt::join(
-        noteStack_ | std::views::transform([](uint8_t v){ return (int)v; }),
-        ", "
-    )));
+    LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "noteStack_ holds {} notes.", noteStack_.size());
     
     if (noteStack_.size() > 1) {
         ActiveNote& lastNote = notes_[noteStack_[noteStack_.size() - 2]];
-        SPDLOG_DEBUG("previous midi note {} is still held. Sending release event", lastNote.note.getMidiNote());
+        LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "previous midi note {} is still held. Sending release event", lastNote.note.getMidiNote());
         lastNote.note.setStatus(false);
         MidiEventHandler::onKeyReleased(lastNote);
     } else {
-        SPDLOG_DEBUG("no previous note held, no note released");
+        LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "no previous note held, no note released");
     }
     
     MidiEventHandler::onKeyPressed(note, rePressed);
@@ -48,22 +45,19 @@ void MonophonicFilter::onKeyPressed(const ActiveNote* note, bool rePressed){
 
 void MonophonicFilter::onKeyReleased(ActiveNote anote){
     uint8_t midiNote = anote.note.getMidiNote();
-    SPDLOG_DEBUG("received release event for midiNote {}.", midiNote);
+    LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "received release event for midiNote {}.", midiNote);
     
     auto it = std::find(noteStack_.begin(), noteStack_.end(), midiNote);
     
     if ( it == noteStack_.end() ){
-        SPDLOG_DEBUG("midiNote was not in the noteStack_. Ignoring.");
+        LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "midiNote was not in the noteStack_. Ignoring.");
         return ;
     } 
 
     bool isActiveNote = ( it == noteStack_.end() - 1 );
-    SPDLOG_DEBUG("Erasing midiNote {} from stack. isActiveNote={}.", (int)midiNote,  isActiveNote);
+    LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "Erasing midiNote {} from stack. isActiveNote={}.", (int)midiNote,  isActiveNote);
     noteStack_.erase(it);
-    SPDLOG_DEBUG("current noteStack_: {}", fmt::format("{}", fmt::join(
-        noteStack_ | std::views::transform([](uint8_t v){ return (int)v; }),
-        ", "
-    )));
+    LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "noteStack_ holds {} notes.", noteStack_.size());
 
     if ( isActiveNote ){
         // release and trigger last
@@ -75,9 +69,9 @@ void MonophonicFilter::onKeyReleased(ActiveNote anote){
             nextANote->note.setStatus(true);
             MidiEventHandler::onKeyPressed(nextANote, false);
         } else {
-            SPDLOG_DEBUG("noteStack_ is empty, will not trigger any note in response to release.");
+            LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "noteStack_ is empty, will not trigger any note in response to release.");
         } 
     } else {
-        SPDLOG_DEBUG("pressed note was not activeNote, not triggering new key press or release.");
+        LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "pressed note was not activeNote, not triggering new key press or release.");
     }   
 }
\ No newline at end of file
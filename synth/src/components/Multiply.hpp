@@ -37,6 +37,18 @@ public:
         double scalar = parameters_->getParameter<ParameterType::SCALAR>()->getInstantaneousValue() ;
         setBufferValue(0, input * scalar) ;
     }
+
+    size_t getTailFrames() const override {
+        return 0 ;
+    }
+
+    bool isGainStage() const override {
+        return !getParameterModulator(ParameterType::SCALAR) && !getParameterDepthModulator(ParameterType::SCALAR) ;
+    }
+
+    double getGain() const override {
+        return parameters_->getParameter<ParameterType::SCALAR>()->getInstantaneousValue() ;
+    }
 };
 
 
@@ -24,6 +24,7 @@
 #include "types/ParameterType.hpp"
 #include "core/BaseModulator.hpp"
 #include "config/Config.hpp"
+#include "diagnostics/LatencyProbe.hpp"
 
 #include <cmath>
 #include <utility>
@@ -46,16 +47,55 @@ PolyOscillator::PolyOscillator(ComponentId id, PolyOscillatorConfig cfg):
     childPool_.initializeAll(*parameters_, 0.0);
 }
 
+size_t PolyOscillator::getActiveVoices() const {
+    return children_.size() ;
+}
+
 bool PolyOscillator::isGenerative() const {
     return true ;
 }
 
+bool PolyOscillator::isPolyphonic() const {
+    return true ;
+}
+
+bool PolyOscillator::isSilent() const {
+    return children_.size() == 0 ;
+}
+
+size_t PolyOscillator::stealVoices(size_t limit){
+    size_t stolen = 0 ;
+    while ( children_.size() > limit ){
+        // released voices go first, by how loud they still are. Held voices by velocity,
+        // their envelope may not have risen yet
+        auto quietest = children_.end() ;
+        double quietestLevel = 0.0 ;
+        for ( auto it = children_.begin() ; it != children_.end() ; ++it ){
+            auto amplitude = it->second->getParameters()->getParameter<ParameterType::AMPLITUDE>() ;
+            double level = released_[it->first] ? amplitude->getInstantaneousValue() : 1.0 + amplitude->getValue() ;
+            if ( quietest == children_.end() || level < quietestLevel ){
+                quietest = it ;
+                quietestLevel = level ;
+            }
+        }
+        if ( quietest->second == watched_ ) watched_ = nullptr ;
+        childPool_.release(quietest->second);
+        children_.erase(quietest);
+        ++stolen ;
+    }
+    return stolen ;
+}
+
 void PolyOscillator::calculateSample(){
     double v = 0.0 ;
-    childPool_.forEachActive([&](Oscillator& obj, std::size_t index){
+    childPool_.forEachActive([&](Oscillator& obj){
         obj.calculateSample();
-        v += obj.data()[index];
-    }, bufferIndex_);
+        v += obj.getCurrentSample(0);
+    });
+    if ( watched_ && std::fabs(watched_->getCurrentSample(0)) > LatencyProbe::THRESHOLD ){
+        LatencyProbe::active()->heard(watchedStamp_);
+        watched_ = nullptr ;
+    }
     setBufferValue(0, v);
 }
 
@@ -66,6 +106,13 @@ void PolyOscillator::tick(){
     });
 }
 
+void PolyOscillator::setBufferSize(size_t frames){
+    BaseModule::setBufferSize(frames);
+    childPool_.forEach([frames](Oscillator& obj){
+        obj.setBufferSize(frames);
+    });
+}
+
 void PolyOscillator::clearBuffer(){
     BaseModule::clearBuffer();
     // now clear children
@@ -75,6 +122,7 @@ void PolyOscillator::clearBuffer(){
 }
 
 void PolyOscillator::onKeyPressed(const ActiveNote* anote, bool rePress){
+    released_[anote->note.getMidiNote()] = false ;
     auto it = children_.find(anote->note.getMidiNote());
     if ( rePress && it != children_.end() ){
         Oscillator* osc = it->second ;
@@ -82,6 +130,7 @@ void PolyOscillator::onKeyPressed(const ActiveNote* anote, bool rePress){
             osc->setFrequency(anote->note.getFrequency());
             osc->setAmplitude(anote->note.getMidiVelocity() / 127.0 );
             updateModulationInitialValue(osc);
+            watchVoice(osc, anote->note.getMidiNote());
         }
         return ;
     }
@@ -97,7 +146,7 @@ void PolyOscillator::onKeyPressed(const ActiveNote* anote, bool rePress){
         for ( auto p : osc->getParameters()->getModulatableParameters()){
             auto pIndex = static_cast<size_t>(p);
             if ( modulators_[pIndex] ){
-                auto modParams = modulators_[pIndex]->getRequiredModulationParameters();
+                const auto& modParams = modulators_[pIndex]->getRequiredModulationParameters();
                 if ( modParams.contains(ModulationParameter::MIDI_NOTE)){
                     modulationData_[static_cast<size_t>(p)].set(ModulationParameter::MIDI_NOTE, anote->note.getMidiNote());
                 }
@@ -105,10 +154,12 @@ void PolyOscillator::onKeyPressed(const ActiveNote* anote, bool rePress){
             }
         }
         children_.insert(std::make_pair(anote->note.getMidiNote(),osc));
+        watchVoice(osc, anote->note.getMidiNote());
     } 
 }
 
 void PolyOscillator::onKeyReleased(ActiveNote anote){
+    released_[anote.note.getMidiNote()] = true ;
     auto it = children_.find(anote.note.getMidiNote());
     if ( it != children_.end() ){
         updateModulationInitialValue(it->second);
@@ -118,14 +169,15 @@ void PolyOscillator::onKeyReleased(ActiveNote anote){
 void PolyOscillator::onKeyOff(ActiveNote anote){
     auto it = children_.find(anote.note.getMidiNote());
     if ( it != children_.end() ){
+        if ( it->second == watched_ ) watched_ = nullptr ;
         childPool_.release(it->second);
         children_.erase(it);
     }
 }
 
-void PolyOscillator::updateParameters(){
-    BaseComponent::updateParameters();
-    childPool_.forEachActive(&Oscillator::updateParameters);
+void PolyOscillator::updateParameters(bool control){
+    BaseComponent::updateParameters(control);
+    childPool_.forEachActive(&Oscillator::updateParameters, control);
 }
 
 BaseModulator* PolyOscillator::getParameterModulator(ParameterType p) const {
@@ -210,4 +262,13 @@ void PolyOscillator::setOverrides(Oscillator* osc){
             osc->setParameterModulationStrategy(p, strategyOverrides_.at(idx).value());
         }
     }
+}
+
+void PolyOscillator::watchVoice(Oscillator* osc, uint8_t midiNote){
+    LatencyProbe* probe = LatencyProbe::active() ;
+    if ( !probe ) return ;
+    if ( uint64_t stamp = probe->watch(midiNote) ){
+        watched_ = osc ;
+        watchedStamp_ = stamp ;
+    }
 }
\ No newline at end of file
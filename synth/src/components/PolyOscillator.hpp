@@ -33,6 +33,9 @@ class PolyOscillator : public BaseModule, public MidiEventListener {
 private:
     RTMap<uint8_t, Oscillator*, 128> children_ ;
     FixedPool<Oscillator, 128> childPool_ ;
+    std::array<bool, 128> released_ {} ; // by midi note, the key of a sounding voice is up
+    Oscillator* watched_ = nullptr ;     // voice the latency probe waits to hear
+    uint64_t watchedStamp_ = 0 ;
 
     // child modulation/parameter storage
     std::array<BaseModulator*, N_PARAMETER_TYPES> modulators_ ;
@@ -46,9 +49,13 @@ public:
     
     // Module Overrides
     bool isGenerative() const override ;
+    bool isPolyphonic() const override ;
+    bool isSilent() const override ;
+    size_t stealVoices(size_t limit) override ;
     void calculateSample() override ;
     void clearBuffer() override ;
     void tick() override ;
+    void setBufferSize(size_t frames) override ;
 
     // MidiEventListener Overrides
     void onKeyPressed(const ActiveNote* note, bool rePress = false) override ;
@@ -56,7 +63,8 @@ public:
     void onKeyOff(ActiveNote anote) override ;
 
     // BaseComponent Overrides
-    void updateParameters() override ;
+    void updateParameters(bool control = true) override ;
+    size_t getActiveVoices() const override ;
     BaseModulator* getParameterModulator(ParameterType p) const  override ;
     void setParameterDepth(ParameterType p, double depth) override ;
     void setParameterModulationStrategy(ParameterType p, ModulationStrategy strat) override ;
@@ -67,6 +75,7 @@ public:
 private:
     void updateModulationInitialValue(Oscillator* osc);
     void setOverrides(Oscillator* osc);
+    void watchVoice(Oscillator* osc, uint8_t midiNote);
 
 };  
 
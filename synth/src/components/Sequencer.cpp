@@ -20,6 +20,7 @@
 #include "types/ParameterType.hpp"
 #include "params/ParameterMap.hpp"
 #include "params/ParameterCollection.hpp"
+#include "diagnostics/Log.hpp"
 
 #include <spdlog/spdlog.h>
 
@@ -55,46 +56,46 @@ void Sequencer::onTick(float dt){
     }
 
     // check to see if sufficient time has passed to process events again
-    auto durations = parameters_->getCollection<ParameterType::DURATION>();
-    if ( beatsSinceLastQuery < durations->getMinValue() ) return ;
+    const auto& durations = parameters_->getCollection<ParameterType::DURATION>()->snapshot();
+    if ( beatsSinceLastQuery < durations.getMinValue() ) return ;
 
     // Process Events...
-    auto notes = parameters_->getCollection<ParameterType::MIDI_VALUE>();
-    auto velocities = parameters_->getCollection<ParameterType::VELOCITY>();
-    auto starts = parameters_->getCollection<ParameterType::START_POSITION>();
+    const auto& notes = parameters_->getCollection<ParameterType::MIDI_VALUE>()->snapshot();
+    const auto& velocities = parameters_->getCollection<ParameterType::VELOCITY>()->snapshot();
+    const auto& starts = parameters_->getCollection<ParameterType::START_POSITION>()->snapshot();
 
-    for ( int i : notes->getIndices() ){
-        float start = starts->getValue(i);
-        float end = start + durations->getValue(i);
+    for ( int i : notes.getIndices() ){
+        float start = starts.getValue(i);
+        float end = start + durations.getValue(i);
 
         
         if ( currentBeat < lastQueriedBeat_ ){ // handle loop around
             // Case 1: last query to loop end
             if ( start > lastQueriedBeat_ && start <= maxBeats ){
-                pushToQueue(notes->getValue(i), velocities->getValue(i), true);
+                pushToQueue(notes.getValue(i), velocities.getValue(i), true);
                 continue ;
             }
             if ( end > lastQueriedBeat_ && end <= maxBeats ){
-                pushToQueue(notes->getValue(i), velocities->getValue(i), false);
+                pushToQueue(notes.getValue(i), velocities.getValue(i), false);
                 continue ;
             }
 
             // Case 2: loop start to current beat
             if ( start >= 0.0f && start <= currentBeat ){
-                pushToQueue(notes->getValue(i), velocities->getValue(i), true);
+                pushToQueue(notes.getValue(i), velocities.getValue(i), true);
                 continue ;
             }
             if ( end >= 0.0f && end <= currentBeat ){
-                pushToQueue(notes->getValue(i), velocities->getValue(i), false);
+                pushToQueue(notes.getValue(i), velocities.getValue(i), false);
                 continue ;
             }
         } else { // hasn't looped yet
             if ( start > lastQueriedBeat_ && start <= currentBeat ){
-                pushToQueue(notes->getValue(i), velocities->getValue(i), true);
+                pushToQueue(notes.getValue(i), velocities.getValue(i), true);
                 continue ;
             }
             if ( end > lastQueriedBeat_ && end <= currentBeat ){
-                pushToQueue(notes->getValue(i), velocities->getValue(i), false);
+                pushToQueue(notes.getValue(i), velocities.getValue(i), false);
                 continue ;
             }
         }
@@ -105,7 +106,7 @@ void Sequencer::onTick(float dt){
 }
 
 void Sequencer::pushToQueue(uint8_t midiNote, uint8_t velocity, bool noteOn){
-    SPDLOG_DEBUG("sending note to queue (note={},velocity={},on={})", midiNote, velocity, noteOn);
+    LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "sending note to queue (note={},velocity={},on={})", midiNote, velocity, noteOn);
     MidiNote m = MidiNote(midiNote, velocity, noteOn);
     ActiveNote anote = {m, 0};
     if ( noteOn ){
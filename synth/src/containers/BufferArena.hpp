@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BUFFER_ARENA_HPP_
+#define __BUFFER_ARENA_HPP_
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+/**
+ * @brief one contiguous, zeroed block of equally sized sample buffers
+ *
+ * Every slot starts on a cache line boundary. Slot 0 is reserved as a read-only
+ * source of silence.
+ */
+class BufferArena {
+public:
+    static constexpr size_t ALIGNMENT = 64 ;
+
+private:
+    double* data_ = nullptr ;
+    size_t nSlots_ ;
+    size_t stride_ ; // doubles per slot, padded to the alignment
+    bool locked_ = false ;
+
+public:
+    BufferArena(size_t nSlots, size_t slotFrames):
+        nSlots_(nSlots + 1),
+        stride_(roundUp(slotFrames))
+    {
+        data_ = static_cast<double*>(::operator new(bytes(), std::align_val_t{ALIGNMENT}));
+        std::memset(data_, 0, bytes());
+    }
+
+    ~BufferArena(){
+        if ( locked_ ) munlock(data_, bytes());
+        ::operator delete(data_, std::align_val_t{ALIGNMENT});
+    }
+
+    BufferArena(const BufferArena&) = delete ;
+    BufferArena& operator=(const BufferArena&) = delete ;
+
+    double* slot(size_t i) const {
+        return data_ + ( i + 1 ) * stride_ ;
+    }
+
+    double* zeros() const {
+        return data_ ;
+    }
+
+    size_t size() const {
+        return nSlots_ - 1 ;
+    }
+
+    size_t bytes() const {
+        return nSlots_ * stride_ * sizeof(double) ;
+    }
+
+    // keep the buffers resident, so the audio thread never faults on them
+    bool lock(){
+        if ( !locked_ ) locked_ = mlock(data_, bytes()) == 0 ;
+        return locked_ ;
+    }
+
+    bool isLocked() const {
+        return locked_ ;
+    }
+
+private:
+    static size_t roundUp(size_t frames){
+        constexpr size_t perLine = ALIGNMENT / sizeof(double) ;
+        return ( frames + perLine - 1 ) / perLine * perLine ;
+    }
+};
+
+#endif // __BUFFER_ARENA_HPP_
@@ -18,6 +18,7 @@
 #ifndef DELAY_BUFFER_HPP_
 #define DELAY_BUFFER_HPP_
 
+#include <algorithm>
 #include <vector>
 
 class DelayBuffer {
@@ -45,6 +46,14 @@ public:
         return buffer_[idx] ;
     }
 
+    size_t capacity() const {
+        return capacity_ ;
+    }
+
+    void clear(){
+        std::fill(buffer_.begin(), buffer_.end(), 0.0f);
+    }
+
     void setCapacity(size_t cap){
         buffer_.resize(cap, 0.0f);
         capacity_ = cap ;
@@ -87,6 +87,14 @@ public:
         }
     }
     
+    // every constructed object, active or not
+    template <typename Func>
+    void forEach(Func&& func) {
+        for (size_t i = 0; i < N; ++i) {
+            std::invoke(func, *reinterpret_cast<T*>(&storage_[i]));
+        }
+    }
+    
     std::size_t countActiveVoices() const {
         return activeCount_;  // Now O(1) instead of O(N)
     }
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MPSC_QUEUE_HPP_
+#define __MPSC_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief bounded lock-free multi-producer / single-consumer queue
+ * 
+ * Each slot carries a sequence number so producers can claim slots with a single CAS and
+ * the consumer can detect when a claimed slot has actually been written. Neither side
+ * allocates after construction.
+ */
+template<typename T>
+class MPSCQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "MPSCQueue: T must be trivially copyable");
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence ;
+        T data ;
+    };
+
+    std::unique_ptr<Slot[]> slots_ ;
+    size_t mask_ ;
+
+    alignas(64) std::atomic<size_t> enqueuePos_{0} ;
+    alignas(64) size_t dequeuePos_ = 0 ;
+
+public:
+    explicit MPSCQueue(size_t capacity){
+        size_t size = 2 ;
+        while ( size < capacity ) size <<= 1 ;
+
+        slots_ = std::make_unique<Slot[]>(size);
+        mask_ = size - 1 ;
+        for ( size_t i = 0 ; i < size ; ++i ){
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete ;
+    MPSCQueue& operator=(const MPSCQueue&) = delete ;
+
+    /**
+     * @brief push an item, safe to call from any number of threads
+     * 
+     * @return false if the queue is full
+     */
+    bool push(const T& item){
+        Slot* slot ;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;){
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if ( diff == 0 ){
+                if ( enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) break ;
+            } else if ( diff < 0 ){
+                return false ;
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->data = item ;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true ;
+    }
+
+    /**
+     * @brief pop the oldest item, only call from the consumer thread
+     * 
+     * @return false if the queue is empty
+     */
+    bool pop(T& item){
+        Slot& slot = slots_[dequeuePos_ & mask_];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if ( static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeuePos_ + 1) < 0 ) return false ;
+
+        item = slot.data ;
+        slot.sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        ++dequeuePos_ ;
+        return true ;
+    }
+
+    size_t capacity() const {
+        return mask_ + 1 ;
+    }
+};
+
+#endif // __MPSC_QUEUE_HPP_
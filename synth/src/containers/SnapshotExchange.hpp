@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SNAPSHOT_EXCHANGE_HPP_
+#define __SNAPSHOT_EXCHANGE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief hands immutable snapshots from a writer to a single realtime reader
+ * 
+ * The writer publishes complete values; the reader adopts the most recent one with one
+ * atomic load and never frees anything. Every snapshot carries a generation number and
+ * the reader reports the last generation it adopted. Since the reader only ever moves
+ * forward, the writer frees older snapshots on its next publish.
+ * 
+ * A reader that stops running (before its first acquire, or after detach) holds nothing,
+ * so while it is detached the writer keeps only the latest snapshot. The reader attaches
+ * again on its next acquire.
+ * 
+ * Writers must be serialized by the caller.
+ */
+template <typename T>
+class SnapshotExchange {
+private:
+    struct Node {
+        uint64_t generation ;
+        T value ;
+    };
+
+    // writer side
+    std::vector<std::unique_ptr<Node>> published_ ;
+    uint64_t generation_ = 0 ;
+
+    // hand-over
+    std::atomic<Node*> latest_{nullptr} ;
+    std::atomic<uint64_t> adopted_{0} ;
+    std::atomic<bool> detached_{true} ;
+
+    // reader side
+    Node* live_ = nullptr ;
+
+public:
+    SnapshotExchange() = default ;
+    SnapshotExchange(const SnapshotExchange&) = delete ;
+    SnapshotExchange& operator=(const SnapshotExchange&) = delete ;
+
+    // ---------------- writer ----------------
+
+    uint64_t publish(T value){
+        auto node = std::make_unique<Node>(Node{++generation_, std::move(value)});
+        latest_.store(node.get(), std::memory_order_seq_cst);
+        published_.push_back(std::move(node));
+
+        // pairs with acquire: a reader attaching after this check loads the node just stored
+        if ( detached_.load(std::memory_order_seq_cst) ){
+            published_.erase(published_.begin(), published_.end() - 1);
+            return generation_ ;
+        }
+
+        uint64_t adopted = adopted_.load(std::memory_order_acquire);
+        published_.erase(
+            std::remove_if(published_.begin(), published_.end() - 1, [adopted](const auto& n){ return n->generation < adopted ; }),
+            published_.end() - 1
+        );
+        return generation_ ;
+    }
+
+    // most recently published value, writer side only
+    const T* latest() const {
+        return published_.empty() ? nullptr : &published_.back()->value ;
+    }
+
+    uint64_t generation() const {
+        return generation_ ;
+    }
+
+    // whether the reader has adopted the latest snapshot, or will when it next acquires
+    bool isCurrent() const {
+        return detached_.load(std::memory_order_seq_cst) || adopted_.load(std::memory_order_acquire) == generation_ ;
+    }
+
+    // ---------------- reader ----------------
+
+    // the reader stopped and holds nothing. Only call while it is not running
+    void detach(){
+        detached_.store(true, std::memory_order_seq_cst);
+    }
+
+    const T* acquire(){
+        if ( detached_.load(std::memory_order_acquire) ){
+            live_ = nullptr ; // may have been freed in the meantime
+            detached_.store(false, std::memory_order_seq_cst);
+        }
+        Node* latest = latest_.load(std::memory_order_seq_cst);
+        if ( latest != live_ ){
+            live_ = latest ;
+            adopted_.store(latest->generation, std::memory_order_release);
+        }
+        return live_ ? &live_->value : nullptr ;
+    }
+};
+
+#endif // __SNAPSHOT_EXCHANGE_HPP_
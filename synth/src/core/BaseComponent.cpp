@@ -100,11 +100,14 @@ void BaseComponent::removeParameterDepthModulation(ParameterType p){
 }
 
 BaseModulator* BaseComponent::getParameterModulator(ParameterType p) const {
-    return parameters_->getParameter(p)->getModulator();
+    ParameterBase* param = parameters_->getParameter(p);
+    return param ? param->getModulator() : nullptr ;
 }
 
 BaseModulator* BaseComponent::getParameterDepthModulator(ParameterType p) const {
-    return parameters_->getParameter(p)->getDepth()->getModulator();
+    ParameterBase* param = parameters_->getParameter(p);
+    if ( !param || !param->getDepth() ) return nullptr ;
+    return param->getDepth()->getModulator();
 }
 
 double BaseComponent::getParameterDepth(ParameterType p) const {
@@ -145,8 +148,12 @@ void BaseComponent::setParameterModulationStrategy(ParameterType p, ModulationSt
     param->setModulationStrategy(strat);
 }
 
-void BaseComponent::updateParameters(){
-    if (parameters_) parameters_->modulate() ;
+void BaseComponent::prepareParameters(size_t nFrames, bool syncCollections){
+    if (parameters_) parameters_->prepareBlock(nFrames, syncCollections);
+}
+
+void BaseComponent::updateParameters(bool control){
+    if (parameters_) parameters_->modulate(control) ;
 }
 
 void BaseComponent::onSetParameterModulation(ParameterType p, BaseModulator* m, ModulationData d ){
@@ -18,6 +18,7 @@
 #ifndef __BASE_COMPONENT_HPP_
 #define __BASE_COMPONENT_HPP_
 
+#include "core/ModuleProfiler.hpp"
 #include "types/ParameterType.hpp"
 #include "types/ComponentType.hpp"
 #include "params/ModulationParameter.hpp"
@@ -41,6 +42,7 @@ protected:
     ComponentType type_ ;
     ParameterMap* parameters_ ; 
     std::unordered_set<BaseModule*> modulationModules_ ; // used only for tracking, see SignalChain for context
+    ComponentProfile profile_ ;
 
 public:
     BaseComponent(ComponentId id = -1, ComponentType type = ComponentType::Unknown);
@@ -51,6 +53,7 @@ public:
     ComponentType getType() const { return type_ ; }
     ParameterMap* getParameters() { return parameters_ ;}
     std::unordered_set<BaseModule*>& getModulationInputs() ;
+    ComponentProfile& getProfile(){ return profile_ ; }
 
     /* depth/modulation are managed from component instead of parameterMap, to allow for
      parent/child component setups. Non-virtual functions in this section have
@@ -68,8 +71,14 @@ public:
     virtual ModulationStrategy getParameterModulationStrategy(ParameterType p) const ;
     virtual void setParameterModulationStrategy(ParameterType p, ModulationStrategy strat);
 
-    // this function runs modulation on all internal parameters
-    virtual void updateParameters();
+    // computes per-block parameter smoothing ramps, called once at the start of each audio block
+    void prepareParameters(size_t nFrames, bool syncCollections = true);
+
+    // advances smoothing on all internal parameters, and their modulation if control is set
+    virtual void updateParameters(bool control = true);
+
+    // number of currently sounding voices/notes, for monitoring
+    virtual size_t getActiveVoices() const { return 0 ; }
 
 protected:
     virtual void onSetParameterModulation(ParameterType p, BaseModulator* m, ModulationData d );
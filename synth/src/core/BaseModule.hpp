@@ -20,9 +20,12 @@
 
 #include <cmath>
 #include <cstddef>
+#include <atomic>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <algorithm>
+#include <span>
 
 #include "core/BaseComponent.hpp"
 #include "config/Config.hpp"
@@ -33,11 +36,19 @@ using json = nlohmann::json ;
 struct SignalConnection {
     BaseModule* module ; // connecting module
     size_t index ; // buffer index 
+    mutable bool feedback = false ; // closes a cycle, reads the source's previous sample. Not part of identity
 
     bool operator==(const SignalConnection& other) const {
         return module == other.module && index == other.index ;
     }
 };
+// a connection as laid out by the processing plan, for the audio thread to read
+struct PlannedInput {
+    const BaseModule* module ;
+    size_t index ;
+    bool feedback ;
+};
+
 struct ConnectionHash {
     std::size_t operator()(const SignalConnection& conn) const {
         return std::hash<BaseModule*>()(conn.module) ^ (std::hash<size_t>()(conn.index) << 1);
@@ -55,23 +66,39 @@ protected:
 
     std::vector<std::unordered_set<SignalConnection, ConnectionHash>> signalInputs_ ;
     std::vector<std::unordered_set<SignalConnection, ConnectionHash>> signalOutputs_ ;
-    std::vector<std::unique_ptr<double[]>> buffers_ ;
+    std::vector<double*> buffers_ ; // where outputs are written, usually a slot in the plan's arena
+    std::vector<std::unique_ptr<double[]>> storage_ ; // used while not part of a plan
+
+    // audio thread: this module's inputs in the active plan, input i is [inputBounds_[i], inputBounds_[i+1])
+    const PlannedInput* plannedInputs_ = nullptr ;
+    const uint32_t* inputBounds_ = nullptr ;
+
+    // block-level silence tracking, audio thread only
+    bool bypassed_ = false ;
+    size_t quietFrames_ = 0 ;
+
+    std::atomic<int> observers_{0} ; // probes reading whole output buffers
+    std::atomic<bool> optional_{false} ; // may be passed through while the engine is overloaded
 
 public:
+    static constexpr size_t TAIL_UNKNOWN = std::numeric_limits<size_t>::max() ;
+
     BaseModule(size_t in, size_t out):
         bufferIndex_(0),
         nInputs_(in),
         nOutputs_(out),
         signalInputs_(in),
         signalOutputs_(out),
-        buffers_(out)
+        buffers_(out),
+        storage_(out)
     {
         Config::load();
         sampleRate_ = Config::get<double>("audio.sample_rate").value();
         bufferSize_ = Config::get<size_t>("audio.buffer_size").value();
 
         for ( size_t i = 0; i < out; ++i){
-            buffers_[i] = std::make_unique<double[]>(bufferSize_);
+            storage_[i] = std::make_unique<double[]>(bufferSize_);
+            buffers_[i] = storage_[i].get() ;
         }
     }
     
@@ -80,6 +107,26 @@ public:
     void setBufferIndex(size_t index){
         bufferIndex_ = index ;
     }
+
+    // frame of the most recently written sample
+    size_t getBufferIndex() const {
+        return bufferIndex_ ;
+    }
+
+    /**
+     * @brief reallocate the output buffers for a new block size
+     * 
+     * Only while the audio stream is stopped. Outputs go back to the module's own storage
+     * until the next plan binds them.
+     */
+    virtual void setBufferSize(size_t frames){
+        bufferSize_ = frames ;
+        bufferIndex_ = 0 ;
+        for ( size_t o = 0 ; o < nOutputs_ ; ++o ){
+            storage_[o] = std::make_unique<double[]>(frames);
+            buffers_[o] = storage_[o].get() ;
+        }
+    }
     
     virtual void calculateSample(){}
 
@@ -89,14 +136,17 @@ public:
     }
 
     virtual void clearBuffer(){
-        for ( auto& buf : buffers_ ){
-            std::fill(buf.get(), buf.get() + bufferSize_, 0.0);
+        for ( double* buf : buffers_ ){
+            // keep the last written sample, feedback edges read it during the next frame
+            double last = buf[bufferIndex_] ;
+            std::fill(buf, buf + bufferSize_, 0.0);
+            buf[bufferIndex_] = last ;
         }
     }
 
     const double* data(size_t output = 0) const {
         assert( output < nOutputs_ );
-        return buffers_[output].get() ;
+        return buffers_[output] ;
     }
 
     std::size_t size() const {
@@ -111,11 +161,18 @@ public:
         return nOutputs_ ;
     }
 
-    void connectInput(BaseModule* source, size_t input, size_t sourceOutput){
-        assert( output < nInputs_ );
+    void connectInput(BaseModule* source, size_t input, size_t sourceOutput, bool feedback = false){
+        assert( input < nInputs_ );
         assert( sourceOutput < source->nOutputs_ );
-        signalInputs_[input].insert({source, sourceOutput});
-        source->signalOutputs_[sourceOutput].insert({this, input});
+        signalInputs_[input].insert({source, sourceOutput, feedback});
+        source->signalOutputs_[sourceOutput].insert({this, input, feedback});
+    }
+
+    void setFeedback(BaseModule* source, size_t input, size_t sourceOutput, bool feedback){
+        auto in = signalInputs_[input].find({source, sourceOutput});
+        if ( in != signalInputs_[input].end() ) in->feedback = feedback ;
+        auto out = source->signalOutputs_[sourceOutput].find({this, input});
+        if ( out != source->signalOutputs_[sourceOutput].end() ) out->feedback = feedback ;
     }
 
     void disconnectInput(BaseModule* source, size_t input, size_t sourceOutput){
@@ -136,18 +193,115 @@ public:
     }
 
     virtual void tick(){
-        bufferIndex_ = std::fmod(bufferIndex_ + 1, bufferSize_);
+        if ( ++bufferIndex_ >= bufferSize_ ) bufferIndex_ = 0 ;
     }
 
     virtual bool isGenerative() const { return false; }
     virtual bool isPolyphonic() const { return false; }
+
+    // polyphonic generators: cut the quietest voices until at most limit remain, returns how many were cut
+    virtual size_t stealVoices([[maybe_unused]] size_t limit){ return 0; }
+
+    // modules with derived coefficients may refresh them only every frames frames
+    virtual void setCoefficientInterval([[maybe_unused]] size_t frames){}
+
+    // generators: nothing to play this block. Asked once per block, after midi events are handled
+    virtual bool isSilent() const { return false; }
+
+    // processors: frames the output can keep ringing once every input is silent
+    virtual size_t getTailFrames() const { return TAIL_UNKNOWN; }
+
+    // drop residual state once the tail has decayed and the module stops being processed
+    virtual void resetTail(){}
+
+    bool isBypassed() const { return bypassed_ ; }
+
+    /**
+     * @brief track how long the inputs have been silent
+     * 
+     * @return true if the tail has decayed and this block can be skipped
+     */
+    bool updateSilence(bool inputsSilent, size_t tailFrames, size_t nFrames){
+        if ( !inputsSilent ){
+            quietFrames_ = 0 ;
+            return false ;
+        }
+        if ( quietFrames_ >= tailFrames ) return true ;
+        quietFrames_ = std::min(quietFrames_ + nFrames, TAIL_UNKNOWN - 1) ;
+        return false ;
+    }
+
+    // a skipped module is pointed at silence by the signal controller
+    void setBypassed(bool bypass){
+        if ( bypass && !bypassed_ ) resetTail();
+        bypassed_ = bypass ;
+    }
+
+    /**
+     * @brief audio thread: write outputs into the given slots, or back into the module's own
+     * storage if null, and move onto the plan's frame index
+     * 
+     * @param carry copy the current samples across, so feedback reads and meters see no gap
+     */
+    void bindOutputs(double* const* slots, size_t index, bool carry = true){
+        for ( size_t o = 0 ; o < nOutputs_ ; ++o ){
+            double* target = slots ? slots[o] : storage_[o].get() ;
+            if ( carry && target != buffers_[o] ) target[index] = buffers_[o][bufferIndex_] ;
+            buffers_[o] = target ;
+        }
+        bufferIndex_ = index ;
+    }
+
+    /**
+     * @brief audio thread: read inputs from the plan's flattened connection list
+     * 
+     * The connection sets are edited by API threads, only the plan's copy is safe to walk
+     * while processing. Unbound modules read silence.
+     */
+    void bindInputs(const PlannedInput* inputs, const uint32_t* bounds){
+        plannedInputs_ = inputs ;
+        inputBounds_ = bounds ;
+    }
+
+    // audio thread: every input the active plan lists for this module
+    std::span<const PlannedInput> getPlannedInputs() const {
+        if ( !inputBounds_ ) return {};
+        return { plannedInputs_ + inputBounds_[0], plannedInputs_ + inputBounds_[nInputs_] };
+    }
+
+    // probes reading whole output buffers keep the module out of buffer sharing
+    void addObserver(){ observers_.fetch_add(1, std::memory_order_relaxed); }
+    void removeObserver(){ observers_.fetch_sub(1, std::memory_order_relaxed); }
+    bool isObserved() const { return observers_.load(std::memory_order_relaxed) > 0 ; }
+
+    // an effect the patch can do without, passed through instead of processed under overload
+    void setOptional(bool optional){ optional_.store(optional, std::memory_order_relaxed); }
+    bool isOptional() const { return optional_.load(std::memory_order_relaxed); }
+
+    // stand-in for a skipped optional module: each input goes straight to the output of the same index
+    void passThrough(){
+        BaseModule::tick();
+        for ( size_t o = 0 ; o < nOutputs_ ; ++o ){
+            setBufferValue(o, o < nInputs_ ? aggregateInputs(o) : 0.0);
+        }
+    }
+
+    // a module whose output is its summed input times an unmodulated gain. Chains of these are folded
+    virtual bool isGainStage() const { return false; }
+    virtual double getGain() const { return 1.0; }
+
+    // stand-in for a folded gain chain ending at this module, starting at head
+    void calculateFolded(const BaseModule& head, double gain){
+        setBufferValue(0, head.aggregateInputs(0) * gain);
+    }
     
 protected:
     double aggregateInputs(size_t idx) const {
         assert( idx < nInputs_ );
+        if ( !inputBounds_ ) return 0.0 ;
         double sum = 0.0 ;
-        for ( const auto& conn : signalInputs_[idx] ){
-            sum += conn.module->getCurrentSample(conn.index);
+        for ( uint32_t i = inputBounds_[idx] ; i < inputBounds_[idx + 1] ; ++i ){
+            sum += plannedInputs_[i].module->getCurrentSample(plannedInputs_[i].index);
         }
         return sum ;
     }
@@ -162,6 +316,7 @@ protected:
 inline void to_json(json& j, const SignalConnection& conn){
     j["componentId"] = conn.module->getId() ;
     j["index"] = conn.index ;
+    if ( conn.feedback ) j["feedback"] = true ;
 };
 
 #endif // __MODULE_HPP_
\ No newline at end of file
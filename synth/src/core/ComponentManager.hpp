@@ -64,14 +64,17 @@ public:
         if ( descriptor.isModule() ) modules_.insert(id);
         if ( descriptor.isModulator() ) modulators_.insert(id);
         if ( descriptor.isMidiListener() ) midiListeners_.insert(id);
-        if ( descriptor.isMidiHandler() ){
-            midiHandlers_.insert(id);
-            midiController_->addHandler(getMidiHandler(id));
-        } 
+        // ticked from the processing plan, the audio thread never walks this registry
+        if ( descriptor.isMidiHandler() ) midiHandlers_.insert(id);
 
         return id;
     }
 
+    // ids are handed out in increasing order and only start over after reset()
+    ComponentId getNextId() const {
+        return nextID_ ;
+    }
+
     BaseComponent* getRaw(ComponentId id) const {
         auto it = components_.find(id);
         if ( it == components_.end() ) return nullptr ;
@@ -126,12 +129,27 @@ public:
         return midiListeners_ ;
     }
 
-    void remove(ComponentId id){
+    // take a component out of the manager without deleting it yet
+    std::unique_ptr<BaseComponent> detach(ComponentId id){
+        auto it = components_.find(id);
+        if ( it == components_.end() ) return nullptr ;
+
         midiHandlers_.erase(id);
         modules_.erase(id);
         modulators_.erase(id);
 
-        components_.erase(id);
+        std::unique_ptr<BaseComponent> component = std::move(it->second);
+        components_.erase(it);
+        return component ;
+    }
+
+    void remove(ComponentId id){
+        detach(id);
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        for ( const auto& [id, component] : components_ ) f(component.get());
     }
 
     void reset(){
@@ -142,12 +160,6 @@ public:
         modules_.clear();
     }
 
-    void runParameterModulation(){
-        for (auto it = components_.begin(); it != components_.end(); ++it){
-            it->second->updateParameters();
-        }
-    }
-
     // saving / loading
     json serializeComponents() const {
         json output ;
@@ -177,6 +189,7 @@ public:
                         componentConfig["signalInputs"][i].push_back(conn);
                     }
                 }
+                if ( module->isOptional() ) componentConfig["optional"] = true ;
             }
 
             // get midi handler listeners
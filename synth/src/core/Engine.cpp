@@ -4,20 +4,30 @@
 
 #include "core/Engine.hpp"
 #include "dsp/AnalyticsEngine.hpp"
+#include "diagnostics/Log.hpp"
+#include "diagnostics/RtCheck.hpp"
+#include "diagnostics/Tracer.hpp"
 #include "config/Config.hpp"
 #include "api/ApiHandler.hpp"
 #include "meta/ComponentRegistry.hpp"
 #include "midi/MidiEventHandler.hpp"
 #include "midi/MidiEventListener.hpp"
 #include "types/SocketType.hpp"
+#include "types/ComponentType.hpp"
 #include "types/Waveform.hpp"
 #include "midi/MidiController.hpp"
+#include "midi/MidiFile.hpp"
+#include "render/WavWriter.hpp"
 #include "dsp/detune.hpp"
 #include "dsp/math.hpp"
 
 #include <chrono>
+#include <cmath>
 #include <csignal>
+#include <cstdio>
+#include <fstream>
 #include <mutex>
+#include <stdexcept>
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <fcntl.h>
@@ -31,6 +41,7 @@ std::atomic<bool> Engine::stop_flag{false};
 void Engine::signalHandler(int signum){
     SPDLOG_INFO("Caught signal {}, stopping threads...", signum);
     stop_flag = true;
+    ApiHandler::instance()->stop();
 }
 
 // Constructor
@@ -40,6 +51,9 @@ Engine::Engine():
     componentFactory(&componentManager),
     signalController(&componentManager), 
     midiController(&midiState_),
+    parameterQueue(&componentManager),
+    probeTable(),
+    sharedParameters(),
     // thread state flags
     apiServerRunning_(false),
     engineRunning_(false),
@@ -51,7 +65,7 @@ Engine::Engine():
     availableAudioDevices_(),
     selectedAudioOutput_(0),
     // midi
-    midiIn_(),
+    midiIn_(nullptr),
     availableMidiPorts_(),
     selectedMidiPort_(-1),
     midiState_(),
@@ -59,10 +73,16 @@ Engine::Engine():
     // analysis
     analysisAudioOut_(48000 * 10)
 {
+    Log::instance()->start();
     ApiHandler::instance()->initialize(this);
 
+    // modules read by output meters keep a buffer of their own
+    probeTable.setObserverHook([this](){ signalController.updateProcessingGraph(); });
+
     registerBaseMidiHandler(&midiDefaultHandler_);
     midiController.addHandler(&midiDefaultHandler_);
+    midiController.setLatencyProbe(&latencyProbe);
+    LatencyProbe::setActive(&latencyProbe);
     signal(SIGINT, Engine::signalHandler);
 
     dsp::initializeDetuneLUT();
@@ -79,11 +99,19 @@ Engine::~Engine() {
 
 void Engine::initialize(){
     Config::load();
+    bufferSize_ = Config::get<unsigned int>("audio.buffer_size").value();
+    moduleProfiler.setEnabled(Config::get<bool>("audio.profile_modules").value_or(false));
+    latencyProbe.setEnabled(Config::get<bool>("audio.latency_probe").value_or(true));
+    Tracer::instance()->setDirectory(Config::get<std::string>("logging.trace_dir").value_or(""));
+    realtimeMode.configure();
+    signalController.setLockBuffers(realtimeMode.locksMemory());
+    governor.configure();
 
     // Get MIDI list
-    int numPorts = midiIn_.getPortCount();
+    midiIn_ = std::make_unique<RtMidiIn>();
+    int numPorts = midiIn_->getPortCount();
     for (int i = 0; i < numPorts; ++i){
-        availableMidiPorts_[i] = midiIn_.getPortName(i);
+        availableMidiPorts_[i] = midiIn_->getPortName(i);
     }
 
     // Get audio device list
@@ -93,6 +121,11 @@ void Engine::initialize(){
         availableAudioDevices_[info.ID] = info.name;
     }
 
+    // optional shared memory control plane for clients on this host
+    if ( Config::get<bool>("server.shared_memory").value_or(false) ){
+        sharedParameters.create(SharedParameterTable::defaultName());
+    }
+
     // Start API server thread
     apiServerRunning_ = true;
     apiServerThread_ = std::thread([&](){
@@ -117,6 +150,7 @@ void Engine::run(){
     SPDLOG_INFO("Starting engine...");
     
     setup();
+    realtimeMode.apply();
     
     engineRunning_ = true;
     
@@ -185,13 +219,210 @@ void Engine::shutdown(){
     // Stop API server
     stop_flag = true;
     apiServerRunning_ = false;
+    ApiHandler::instance()->stop();
     
     if (apiServerThread_.joinable()){
         SPDLOG_INFO("Waiting for API server thread...");
         apiServerThread_.join();
     }
+
+    // a trace still running is written out rather than lost
+    if ( Tracer::enabled() ){
+        Tracer::instance()->stop();
+    }
     
     SPDLOG_INFO("Engine shutdown complete");
+    Log::instance()->stop();
+}
+
+void Engine::prepareRender(){
+    Config::load();
+    bufferSize_ = Config::get<unsigned int>("audio.buffer_size").value();
+    setup();
+}
+
+int Engine::render(const RenderOptions& options){
+    prepareRender();
+
+    // the patch file is what the gui saves, load it like the gui does
+    std::ifstream file(options.patch);
+    json patch = json::parse(file, nullptr, false);
+    if ( !file || patch.is_discarded() || !patch.is_object() ){
+        SPDLOG_ERROR("Cannot read patch {}", options.patch);
+        return 1 ;
+    }
+    patch["action"] = "load_configuration" ;
+    json loaded = ApiHandler::instance()->handleRequest(patch);
+    if ( loaded.value("status", "") != "success" ){
+        return 1 ;
+    }
+
+    MidiFile midi ;
+    if ( !options.midi.empty() && !midi.load(options.midi) ){
+        return 1 ;
+    }
+
+    double seconds = options.seconds > 0 ? options.seconds : midi.getDuration() + options.tail ;
+    size_t total = static_cast<size_t>(std::llround(seconds * sampleRate_));
+
+    WavWriter wav ;
+    if ( !wav.open(options.out, static_cast<uint32_t>(sampleRate_)) ){
+        return 1 ;
+    }
+
+    SPDLOG_INFO("Rendering {:.2f} s of {} to {}", seconds, options.patch, options.out);
+    std::vector<double> block(bufferSize_);
+    const auto& events = midi.getEvents();
+    auto next = events.begin();
+    size_t frame = 0 ;
+    auto start = std::chrono::steady_clock::now();
+
+    // blocks are cut at event times, so notes start on the frame they are due
+    while ( frame < total && !stop_flag ){
+        for ( ; next != events.end() && std::llround(next->time * sampleRate_) <= static_cast<long long>(frame) ; ++next ){
+            std::vector<unsigned char> message = next->message ;
+            MidiController::onMidiEvent(0.0, &message, &midiController);
+        }
+
+        size_t n = std::min<size_t>(bufferSize_, total - frame);
+        if ( next != events.end() ){
+            n = std::min<size_t>(n, std::llround(next->time * sampleRate_) - frame);
+        }
+
+        {
+            RtCheck::Scope realtime ;
+            renderBlock(block.data(), n);
+        }
+        if ( !wav.write(block.data(), n) ) return 1 ;
+        frame += n ;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if ( !wav.close() ) return 1 ;
+
+    double rendered = frame / sampleRate_ ;
+    SPDLOG_INFO("Rendered {:.2f} s in {:.3f} s ({:.1f}x realtime)", rendered, elapsed, elapsed > 0 ? rendered / elapsed : 0.0);
+
+    // with SYNTH_RT_CHECK a render doubles as a realtime safety test of the patch
+    if ( RtCheck::getTotal() > 0 ){
+        SPDLOG_ERROR("Audio path made realtime unsafe calls: {}", RtCheck::report().dump());
+        return 1 ;
+    }
+    return stop_flag ? 1 : 0 ;
+}
+
+int Engine::latencyTest(int notes, const std::string& patch){
+    prepareRender();
+    latencyProbe.setEnabled(true);
+    realtimeMode.configure();
+    signalController.setLockBuffers(realtimeMode.locksMemory());
+    realtimeMode.apply();
+    governor.configure();
+    ApiHandler* api = ApiHandler::instance();
+
+    if ( !patch.empty() ){
+        std::ifstream file(patch);
+        json configuration = json::parse(file, nullptr, false);
+        if ( !file || configuration.is_discarded() || !configuration.is_object() ){
+            SPDLOG_ERROR("Cannot read patch {}", patch);
+            return 1 ;
+        }
+        configuration["action"] = "load_configuration" ;
+        if ( api->handleRequest(configuration).value("status", "") != "success" ) return 1 ;
+    } else {
+        // a bare oscillator on the root midi handler, audible from the first frame of a voice
+        json added = api->handleRequest({{"action", "add_component"}, {"type", ComponentType::PolyOscillator}, {"name", "latency test"}});
+        if ( added.value("status", "") != "success" ) return 1 ;
+
+        ConnectionRequest midi ;
+        midi.outboundSocket = SocketType::MidiOutbound ;
+        midi.inboundSocket = SocketType::MidiInbound ;
+        midi.inboundID = added["componentId"].get<int>() ;
+
+        ConnectionRequest out ;
+        out.outboundSocket = SocketType::SignalOutbound ;
+        out.inboundSocket = SocketType::SignalInbound ;
+        out.outboundID = added["componentId"].get<int>() ;
+        out.outboundIdx = 0 ;
+        out.inboundIdx = 0 ;
+
+        if ( api->handleRequest(midi).value("status", "") != "success" ) return 1 ;
+        if ( api->handleRequest(out).value("status", "") != "success" ) return 1 ;
+    }
+
+    // notes go out through a virtual port and come back in like a keyboard's would. Without
+    // a midi system that supports virtual ports they are handed to the controller directly
+    const std::string portName = "Syndesium latency test" ;
+    std::unique_ptr<RtMidiOut> sender ;
+    try {
+        midiIn_ = std::make_unique<RtMidiIn>();
+        Tracer::instance()->reserveThread("midi");
+        midiIn_->openVirtualPort(portName);
+        midiIn_->setCallback(&MidiController::onMidiEvent, static_cast<void*>(&midiController));
+        sender = std::make_unique<RtMidiOut>();
+        bool connected = false ;
+        for ( unsigned int i = 0 ; i < sender->getPortCount() && !connected ; ++i ){
+            if ( sender->getPortName(i).find(portName) != std::string::npos ){
+                sender->openPort(i);
+                connected = true ;
+            }
+        }
+        if ( !connected ) throw std::runtime_error("virtual port is not listed");
+    } catch ( const std::exception& e ){
+        SPDLOG_WARN("No midi loopback ({}), delivering notes directly.", e.what());
+        sender.reset();
+        midiIn_.reset();
+    }
+
+    auto send = [&](std::vector<unsigned char> message){
+        if ( sender ) sender->sendMessage(&message);
+        else MidiController::onMidiEvent(0.0, &message, &midiController);
+    };
+
+    // the null device runs the real callback, paced like a sound card would pace it
+    engineStats.setSampleRate(sampleRate_);
+    engineRunning_ = true ;
+    audioRunning_ = true ;
+    realtimeMode.arm();
+    std::thread device([this](){
+        std::vector<double> out(bufferSize_);
+        auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(bufferSize_ / sampleRate_)
+        );
+        auto next = std::chrono::steady_clock::now();
+        while ( audioRunning_ ){
+            audioCallback(out.data(), nullptr, bufferSize_, 0.0, 0, this);
+            next += period ;
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    SPDLOG_INFO("Measuring {} notes at {} frames per block.", notes, bufferSize_);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    for ( int i = 0 ; i < notes && !stop_flag ; ++i ){
+        unsigned char note = static_cast<unsigned char>(48 + i % 24);
+        send({0x90, note, 100});
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        send({0x80, note, 0});
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    if ( midiIn_ ){
+        midiIn_->cancelCallback();
+        midiIn_.reset();
+    }
+    audioRunning_ = false ;
+    engineRunning_ = false ;
+    device.join();
+
+    json stats = latencyProbe.describe();
+    std::printf("%s\n", stats.dump(4).c_str());
+
+    if ( RtCheck::getTotal() > 0 ){
+        SPDLOG_ERROR("Audio path made realtime unsafe calls: {}", RtCheck::report().dump());
+        return 1 ;
+    }
+    return stats["count"].get<uint64_t>() > 0 && !stop_flag ? 0 : 1 ;
 }
 
 // ============================================================================
@@ -203,10 +434,11 @@ void Engine::midiLoop(){
     
     // Open MIDI port
     int deviceId = getMidiDeviceId();
-    if (deviceId >= 0){
-        midiIn_.openPort(deviceId);
-        midiIn_.setCallback(&MidiController::onMidiEvent, static_cast<void*>(&midiController));
-        midiIn_.ignoreTypes(false, false, false);
+    if (deviceId >= 0 && midiIn_){
+        Tracer::instance()->reserveThread("midi");
+        midiIn_->openPort(deviceId);
+        midiIn_->setCallback(&MidiController::onMidiEvent, static_cast<void*>(&midiController));
+        midiIn_->ignoreTypes(false, false, false);
         SPDLOG_INFO("Listening for MIDI input on device id {}", deviceId);
     }
     
@@ -228,7 +460,7 @@ void Engine::audioLoop(){
     RtAudio::StreamParameters parameters;
     RtAudio::StreamOptions options ;
     options.flags = RTAUDIO_SCHEDULE_REALTIME ;
-    options.priority = 50 ;
+    options.priority = realtimeMode.isEnabled() ? realtimeMode.getPriority() : 50 ;
 
     std::map<int,std::string> devices = getAvailableAudioDevices();
     int deviceId = getAudioDeviceId();
@@ -246,23 +478,26 @@ void Engine::audioLoop(){
     parameters.nChannels = 1;
     parameters.firstChannel = 0;
     
-    // Validate sample rate
+    // Validate sample rate. Components cached the configured rate, so the patch keeps
+    // rendering at it and the output is resampled to the device
+    unsigned int deviceRate = sampleRate ;
     auto &sampleRates = deviceInfo.sampleRates;
     if (std::count(sampleRates.begin(), sampleRates.end(), sampleRate) == 0){
         SPDLOG_WARN("Configured sample rate of {} is not supported by device {}.", sampleRate, deviceInfo.name);
-        SPDLOG_INFO("Setting to device preferred sample rate of {}.", deviceInfo.preferredSampleRate);
-        sampleRate = deviceInfo.preferredSampleRate;
-        Config::set("audio.sample_rate", sampleRate);
+        SPDLOG_INFO("Resampling to device preferred sample rate of {}.", deviceInfo.preferredSampleRate);
+        deviceRate = deviceInfo.preferredSampleRate;
     }
 
     sampleRate_ = sampleRate ;
+    resampler_.reset();
+    engineStats.setSampleRate(deviceRate);
     
     // Open audio stream
     if (dac_.openStream(
         &parameters,
         NULL,
         RTAUDIO_FLOAT64,
-        sampleRate,
+        deviceRate,
         &buffer,
         &audioCallback,
         userData,
@@ -272,10 +507,32 @@ void Engine::audioLoop(){
         audioRunning_ = false;
         return;
     }
+
+    // the device may not honour the requested block size, so size module buffers to what it delivers
+    if ( buffer != Config::get<unsigned int>("audio.buffer_size").value() ){
+        SPDLOG_WARN("Device {} uses a buffer size of {} frames.", deviceInfo.name, buffer);
+        Config::set("audio.buffer_size", buffer);
+    }
+    if ( buffer != bufferSize_ ){
+        resizeBuffers(buffer);
+    }
+    SPDLOG_INFO("Audio block size {} frames ({:.2f} ms).", buffer, 1000.0 * buffer / deviceRate);
+    latencyProbe.setStreamLatency(1000.0 * dac_.getStreamLatency() / deviceRate);
+
+    if ( deviceRate != sampleRate ){
+        size_t taps = Config::get<size_t>("audio.resampler_taps").value_or(64);
+        resampler_ = std::make_unique<Resampler>(sampleRate, deviceRate, taps);
+        renderBuffer_.assign(resampler_->maxInputFramesFor(buffer), 0.0);
+        SPDLOG_INFO("Resampling {} -> {} Hz, {:.1f} frames of latency.", sampleRate, deviceRate, resampler_->getLatency());
+    }
     
-    // Start the stream
+    // Start the stream, parameter changes are handed to the callback from here on
+    Tracer::instance()->reserveThread("audio");
+    parameterQueue.setRealtime(true);
+    realtimeMode.arm();
     if (dac_.startStream()){
         SPDLOG_ERROR("Error starting audio stream: {}",  dac_.getErrorText());
+        parameterQueue.setRealtime(false);
         if (dac_.isStreamOpen()){
             dac_.closeStream();
         }
@@ -296,6 +553,7 @@ void Engine::audioLoop(){
 
 void Engine::analysisLoop(){
     SPDLOG_INFO("Analysis thread started");
+    Tracer::setThreadName("analysis");
     
     Config::load();
 
@@ -304,12 +562,20 @@ void Engine::analysisLoop(){
     size_t bufferSize = Config::get<int>("analysis.spectrum_analyzer.buffer_size").value_or(2048);
     std::vector<double> buffer(bufferSize);
     
+    // callback statistics are rolled into the history once a second
+    auto nextStatsSample = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
     while (analysisRunning_ && engineRunning_){
         size_t count = analysisAudioOut_.pop(buffer.data(), buffer.size());
         
         if (count > 0){
             AnalyticsEngine::instance()->analyzeBuffer(buffer.data(), count);
         } 
+
+        if ( std::chrono::steady_clock::now() >= nextStatsSample ){
+            engineStats.sampleHistory();
+            nextStatsSample += std::chrono::seconds(1);
+        }
         
         std::this_thread::sleep_for(std::chrono::milliseconds(30));
     }
@@ -325,7 +591,7 @@ void Engine::analysisLoop(){
 int Engine::audioCallback(
     void *outputBuffer, [[maybe_unused]] void *inputBuffer, 
     unsigned int nBufferFrames, [[maybe_unused]] double streamTime, 
-    [[maybe_unused]] RtAudioStreamStatus status, void *userData 
+    RtAudioStreamStatus status, void *userData 
 ){
     Engine* engine = static_cast<Engine*>(userData);
     double* buffer = static_cast<double*>(outputBuffer);
@@ -337,19 +603,100 @@ int Engine::audioCallback(
         return 1; // Non-zero signals stream should stop
     }
     
-    engine->signalController.clearBuffer();
+    // first callback of a stream in realtime mode, the setup makes syscalls
+    if ( engine->realtimeMode.isPending() ){
+        engine->realtimeMode.prepareAudioThread();
+    }
+
+    RtCheck::Scope realtime ;
+    Tracer::setThreadName("audio");
+    TRACE_SCOPE("audio_callback");
+    auto start = std::chrono::steady_clock::now();
+
+    if ( !engine->resampler_ ){
+        engine->renderBlock(buffer, nBufferFrames);
+    } else {
+        // render at the patch's rate, then convert to the device's
+        unsigned int chunk ;
+        for (unsigned int offset = 0; offset < nBufferFrames; offset += chunk){
+            chunk = std::min(nBufferFrames - offset, engine->bufferSize_);
+            size_t nIn = engine->resampler_->inputFramesFor(chunk);
+            if ( nIn > 0 ) engine->renderBlock(engine->renderBuffer_.data(), nIn);
+            engine->resampler_->process(engine->renderBuffer_.data(), buffer + offset, chunk);
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    engine->latencyProbe.endBlock();
+    engine->engineStats.recordBlock(elapsed.count(), nBufferFrames, status & RTAUDIO_OUTPUT_UNDERFLOW);
+    TRACE_COUNTER("dsp_load", engine->engineStats.getLoad());
+    if ( status & RTAUDIO_OUTPUT_UNDERFLOW ){
+        TRACE_INSTANT("xrun");
+        LOG_RT(LogSubsystem::AUDIO, spdlog::level::debug, "Output underflow, {} xruns so far.", engine->engineStats.getXruns());
+    }
+
+    if ( engine->governor.update(engine->engineStats.getLoad(), status & RTAUDIO_OUTPUT_UNDERFLOW) ){
+        OverloadGovernor::Level level = engine->governor.getLevel();
+        engine->signalController.setQuality(engine->governor.getQuality());
+        TRACE_COUNTER("governor_level", level);
+        LOG_RT(LogSubsystem::AUDIO, spdlog::level::info, "Overload governor at level {} ({}).", level, OverloadGovernor::getLevelName(level));
+    }
+    return 0;
+}
+
+void Engine::renderBlock(double* buffer, unsigned int nBufferFrames){
+    TRACE_SCOPE("render_block");
+    // API threads add and remove components meanwhile, ids are resolved through the adopted plan only
+    parameterQueue.collect();
+    signalController.beginBlock();
+    bool syncCollections = parameterQueue.beginBlock(signalController.getComponentTable(), nBufferFrames);
+    // ids the plan doesn't know yet stay pending, removed ones resolve to nothing
+    sharedParameters.drain([this](int id, ParameterType p, double value){
+        // slots are written by other processes, a NaN would otherwise poison the ramp
+        if ( !dsp::isFinite(value) ) return ;
+        if ( BaseComponent* c = signalController.resolve(id) ){
+            c->getParameters()->setTargetDispatch(p, value);
+        }
+    }, signalController.getComponentTable().size());
+
+    float bufferDt = nBufferFrames / static_cast<float>(getSampleRate());
+    signalController.prepareParameters(nBufferFrames, syncCollections);
+    midiController.tick(bufferDt);
+    signalController.tickMidiHandlers(bufferDt);
+
+    // hosts may deliver blocks larger than the module buffers, process those in pieces
+    bool profile = moduleProfiler.beginBlock();
+    unsigned int chunk ;
+    for (unsigned int offset = 0; offset < nBufferFrames; offset += chunk){
+        chunk = std::min(nBufferFrames - offset, bufferSize_);
+        signalController.prepareBlock(chunk);
+        if ( profile ){
+            renderFrames<true>(buffer, offset, offset + chunk);
+        } else {
+            renderFrames<false>(buffer, offset, offset + chunk);
+        }
+        probeTable.sample(chunk);
+    }
+    parameterQueue.endBlock(nBufferFrames);
+
+    if ( profile ){
+        moduleProfiler.endBlock(nBufferFrames, getSampleRate(), [this](auto&& close){
+            signalController.forEachScheduled([&close](BaseComponent* c){ close(c->getProfile()); });
+        });
+    }
+    
+    analysisAudioOut_.push(buffer, nBufferFrames);
+}
 
-    float bufferDt = nBufferFrames / static_cast<float>(engine->getSampleRate());
-    engine->midiController.tick(bufferDt);
+template <bool Profile>
+void Engine::renderFrames(double* buffer, unsigned int begin, unsigned int end){
     double sample;
-    for (unsigned int i = 0; i < nBufferFrames; ++i){
-        engine->componentManager.runParameterModulation();
-        sample = engine->signalController.processFrame();
+    for (unsigned int i = begin; i < end; ++i){
+        parameterQueue.applyUntil(i);
+        signalController.runParameterModulation<Profile>();
+        sample = signalController.processFrame<Profile>();
         buffer[i] = dsp::fastAtan(sample);
     }
-    
-    engine->analysisAudioOut_.push(buffer, nBufferFrames);
-    return 0;
 }
 
 // ============================================================================
@@ -361,16 +708,33 @@ void Engine::stopAudio(){
     if (dac_.isStreamRunning()){
         dac_.stopStream();
     }
+    parameterQueue.setRealtime(false);
     if (dac_.isStreamOpen()){
         dac_.closeStream();
     }
+    // nothing reads plans or probes until the next stream starts
+    signalController.detachAudio();
+    probeTable.detach();
+}
+
+// reallocate every module buffer and re-plan. Only while no stream is running
+void Engine::resizeBuffers(unsigned int frames){
+    {
+        SignalController::BulkUpdate bulk(signalController);
+        componentManager.forEach([frames](BaseComponent* c){
+            if ( BaseModule* m = dynamic_cast<BaseModule*>(c) ) m->setBufferSize(frames);
+        });
+        bufferSize_ = frames ;
+    }
+    signalController.updateProcessingGraph();
+    SPDLOG_INFO("Module buffers resized to {} frames.", frames);
 }
 
 void Engine::stopMidi(){
     SPDLOG_INFO("Stopping MIDI...");
-    if (midiIn_.isPortOpen()){
-        midiIn_.cancelCallback();
-        midiIn_.closePort();
+    if (midiIn_ && midiIn_->isPortOpen()){
+        midiIn_->cancelCallback();
+        midiIn_->closePort();
     }
 }
 
@@ -393,8 +757,11 @@ void Engine::setup(){
 }
 
 void Engine::destroy(){
-    componentManager.reset();
     signalController.reset();
+    // ids start over, nothing written for the old components may reach new ones
+    for ( ComponentId id = 0 ; id < componentManager.getNextId() ; ++id ) sharedParameters.discard(id);
+    parameterQueue.discardPending();
+    componentManager.reset();
     midiState_.reset();
 }
 
@@ -407,7 +774,7 @@ RtAudio* Engine::getDac(){
 }
 
 RtMidiIn* Engine::getMidiIn(){
-    return &midiIn_;
+    return midiIn_.get();
 }
 
 MidiController* Engine::getMidiController(){
@@ -422,6 +789,39 @@ int Engine::getSampleRate() const {
     return sampleRate_ ;
 }
 
+unsigned int Engine::getBufferSize() const {
+    return bufferSize_ ;
+}
+
+bool Engine::setBufferSize(unsigned int frames){
+    if ( frames < MIN_BUFFER_SIZE || frames > MAX_BUFFER_SIZE ){
+        SPDLOG_ERROR("Cannot set buffer size to {}. Must be between {} and {} frames.", frames, MIN_BUFFER_SIZE, MAX_BUFFER_SIZE);
+        return false ;
+    }
+
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    Config::set("audio.buffer_size", frames);
+
+    if ( !engineRunning_ ){
+        resizeBuffers(frames);
+        SPDLOG_INFO("buffer size set to {}.", frames);
+        return true ;
+    }
+
+    // the block size is fixed when a stream opens, so reopen it
+    audioRunning_ = false ;
+    stopAudio();
+    if (audioThread_.joinable()){
+        audioThread_.join();
+    }
+
+    resizeBuffers(frames);
+    audioRunning_ = true ;
+    audioThread_ = std::thread(&Engine::audioLoop, this);
+    SPDLOG_INFO("buffer size set to {}, audio restarted.", frames);
+    return true ;
+}
+
 int Engine::getAudioDeviceId() const {
     return selectedAudioOutput_;
 }
@@ -628,8 +1028,30 @@ bool Engine::handleSignalConnection(ConnectionRequest request){
         return true ;
     }
 
-    signalController.connect(outbound, request.outboundIdx.value(), inbound, request.inboundIdx.value());
-    return true ;
+    return signalController.connect(outbound, request.outboundIdx.value(), inbound, request.inboundIdx.value());
+}
+
+bool Engine::connectionCreatesCycle(const ConnectionRequest& request){
+    if ( request.remove || !request.outboundID.has_value() || !request.inboundID.has_value() ) return false ;
+    // signal cycles are closed with a feedback edge instead
+    if ( request.inboundSocket != SocketType::ModulationInbound ) return false ;
+
+    BaseModule* outbound = dynamic_cast<BaseModule*>(componentManager.getRaw(request.outboundID.value()));
+    BaseModule* inbound = componentManager.getModule(request.inboundID.value());
+    if ( !outbound || !inbound ) return false ;
+
+    return signalController.createsCycle(outbound, inbound);
+}
+
+bool Engine::isFeedbackConnection(const ConnectionRequest& request){
+    if ( request.inboundSocket != SocketType::SignalInbound ) return false ;
+    if ( !request.outboundID.has_value() || !request.inboundID.has_value() ) return false ;
+
+    BaseModule* outbound = componentManager.getModule(request.outboundID.value());
+    BaseModule* inbound = componentManager.getModule(request.inboundID.value());
+    if ( !outbound || !inbound ) return false ;
+
+    return signalController.isFeedback(outbound, request.outboundIdx.value(), inbound, request.inboundIdx.value());
 }
 
 std::vector<ConnectionRequest> Engine::getComponentSignalConnections(ComponentId id) const {
@@ -663,6 +1085,7 @@ std::vector<ConnectionRequest> Engine::getComponentSignalConnections(ComponentId
                 req.outboundID = conn.module->getId() ;
                 req.outboundIdx = conn.index ;
                 req.outboundSocket = SocketType::SignalOutbound ;
+                req.feedback = conn.feedback ;
                 v.push_back(req);
             }
         }    
@@ -679,6 +1102,7 @@ std::vector<ConnectionRequest> Engine::getComponentSignalConnections(ComponentId
                 req.outboundID = id ;
                 req.outboundIdx = i ;
                 req.outboundSocket = SocketType::SignalOutbound ;
+                req.feedback = conn.feedback ;
                 v.push_back(req);
             }
         }
@@ -702,6 +1126,13 @@ bool Engine::handleModulationConnection(ConnectionRequest request){
         return false ;
     }
 
+    BaseModule* modulatorModule = dynamic_cast<BaseModule*>(modulator);
+    BaseModule* componentModule = componentManager.getModule(request.inboundID.value());
+    if ( !request.remove && modulatorModule && componentModule && signalController.createsCycle(modulatorModule, componentModule) ){
+        SPDLOG_WARN("modulating component {} with {} would create a cycle", request.inboundID.value(), request.outboundID.value());
+        return false ;
+    }
+
     if ( request.depthConnection ){
         if ( request.remove ){
             component->removeParameterDepthModulation(request.inboundParameter.value());
@@ -717,9 +1148,11 @@ bool Engine::handleModulationConnection(ConnectionRequest request){
     }
     
     // stateful modulators need to be in the signal processing graph
-    if ( dynamic_cast<BaseModule*>(modulator) ){
-        signalController.updateProcessingGraph();
+    if ( componentModule ){
+        return signalController.updateModulation(componentModule);
     }
+    // the parameter schedule follows modulation links either way
+    signalController.updateProcessingGraph();
 
     return true ;
 }
@@ -19,6 +19,7 @@
 #define __ENGINE_HPP_
 
 #include <atomic>
+#include <memory>
 
 #include <map>
 #include <rtmidi/RtMidi.h>
@@ -32,6 +33,16 @@
 #include "signal/SignalController.hpp"
 #include "core/ComponentManager.hpp"
 #include "core/ComponentFactory.hpp"
+#include "core/ParameterChangeQueue.hpp"
+#include "core/ProbeTable.hpp"
+#include "core/EngineStats.hpp"
+#include "core/ModuleProfiler.hpp"
+#include "core/RealtimeMode.hpp"
+#include "core/OverloadGovernor.hpp"
+#include "diagnostics/LatencyProbe.hpp"
+#include "ipc/SharedParameterTable.hpp"
+#include "dsp/Resampler.hpp"
+#include "render/RenderOptions.hpp"
 
 #include <nlohmann/json.hpp> 
 
@@ -48,10 +59,18 @@ public:
     void run();
     void stop();
     void shutdown();
+    int render(const RenderOptions& options); // headless, no devices or api server
+    void prepareRender(); // set up for driving renderBlock directly, without a stream
+    int latencyTest(int notes, const std::string& patch); // midi loopback into a null audio device
     
     // Static functions
     static void signalHandler(int signum);
     static std::atomic<bool> stop_flag;
+
+    // block sizes accepted from the api, the device may still negotiate something else
+    static constexpr unsigned int MIN_BUFFER_SIZE = 16 ;
+    static constexpr unsigned int MAX_BUFFER_SIZE = 4096 ;
+    static_assert(ParameterChangeQueue::MAX_FRAME_OFFSET == MAX_BUFFER_SIZE, "timestamped changes reach one largest block ahead");
     
     // Audio callback
     static int audioCallback(
@@ -62,6 +81,9 @@ public:
         RtAudioStreamStatus status, 
         void *userData
     );
+
+    // render nBufferFrames at the patch's sample rate
+    void renderBlock(double* buffer, unsigned int nBufferFrames);
     
     // Getters
     RtAudio* getDac();
@@ -69,6 +91,7 @@ public:
     MidiController* getMidiController();
     MidiEventHandler* getDefaultMidiHandler();
     int getSampleRate() const ;
+    unsigned int getBufferSize() const ;
     int getAudioDeviceId() const;
     int getMidiDeviceId() const;
     const std::map<int,std::string> getAvailableMidiDevices() const;
@@ -77,6 +100,7 @@ public:
     // Setters
     bool setAudioDeviceId(int deviceId);
     bool setMidiDeviceId(int deviceId);
+    bool setBufferSize(unsigned int frames);
     
     // Connection Management
     bool handleMidiConnection(ConnectionRequest connection);
@@ -85,6 +109,8 @@ public:
     std::vector<ConnectionRequest> getComponentMidiConnections(ComponentId id) const ;
 
     bool handleSignalConnection(ConnectionRequest request);
+    bool connectionCreatesCycle(const ConnectionRequest& request);
+    bool isFeedbackConnection(const ConnectionRequest& request);
     std::vector<ConnectionRequest> getComponentSignalConnections(ComponentId id) const ;
 
     bool handleModulationConnection(ConnectionRequest request);
@@ -97,6 +123,14 @@ public:
     ComponentFactory componentFactory;
     SignalController signalController;
     MidiController midiController;
+    ParameterChangeQueue parameterQueue;
+    ProbeTable probeTable;
+    EngineStats engineStats; // written by the audio callback
+    ModuleProfiler moduleProfiler; // per component timing, off unless audio.profile_modules is set
+    LatencyProbe latencyProbe; // note-on to first audible block
+    RealtimeMode realtimeMode; // memory locking and audio thread setup, off unless realtime.enabled is set
+    OverloadGovernor governor; // sheds work under overload, off unless governor.enabled is set
+    SharedParameterTable sharedParameters; // mapped only when server.shared_memory is enabled
 
 private:
     // Thread entry points
@@ -109,6 +143,8 @@ private:
     void destroy();
     void stopAudio();
     void stopMidi();
+    void resizeBuffers(unsigned int frames);
+    template <bool Profile> void renderFrames(double* buffer, unsigned int begin, unsigned int end);
     static void audioCleanup(RtAudio* dac, RtAudioErrorType error);
     
     // Thread management
@@ -129,8 +165,10 @@ private:
     RtAudio dac_;
     std::map<int, std::string> availableAudioDevices_;
     int selectedAudioOutput_;
+    std::unique_ptr<Resampler> resampler_; // set while the device runs at another rate than the patch
+    std::vector<double> renderBuffer_;
     
-    RtMidiIn midiIn_;
+    std::unique_ptr<RtMidiIn> midiIn_; // opened in initialize, a render needs no midi system
     std::map<int, std::string> availableMidiPorts_;
     int selectedMidiPort_;
     
@@ -141,6 +179,7 @@ private:
     LockFreeRingBuffer<double> analysisAudioOut_;
     
     double sampleRate_ ;
+    unsigned int bufferSize_ ; // frames per module buffer, only changed while the stream is closed
 };
 
 #endif // __ENGINE_HPP_
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ENGINE_STATS_HPP_
+#define __ENGINE_STATS_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+/**
+ * @brief execution statistics of the audio callback
+ *
+ * The audio thread is the only writer and records one entry per callback with
+ * relaxed atomics. DSP load is the time spent in the callback over the duration of
+ * audio it produced, so anything at or above 1.0 missed its deadline.
+ *
+ * Block times are also counted in a histogram of power of two buckets: bucket 0
+ * holds blocks under 1 us and bucket k >= 1 holds [2^(k-1), 2^k) us, the last
+ * bucket taking everything longer.
+ */
+class EngineStats {
+public:
+    static constexpr size_t N_BUCKETS = 18 ;    // up to ~65 ms, then overflow
+    static constexpr size_t HISTORY_SIZE = 60 ; // rolling history, one entry per sampleHistory() call
+
+    struct Interval {
+        double time ;     // seconds since the stats were created
+        uint64_t blocks ;
+        uint64_t xruns ;
+        uint64_t late ;   // blocks over budget
+        double meanLoad ;
+        double maxLoad ;
+    };
+
+private:
+    std::atomic<double> sampleRate_{48000.0} ;
+
+    std::atomic<uint64_t> blocks_{0} ;
+    std::atomic<uint64_t> xruns_{0} ;
+    std::atomic<uint64_t> late_{0} ;
+    std::atomic<uint64_t> busyNs_{0} ;
+    std::atomic<uint64_t> budgetNs_{0} ;
+    std::atomic<uint64_t> minNs_{std::numeric_limits<uint64_t>::max()} ;
+    std::atomic<uint64_t> maxNs_{0} ;
+    std::atomic<double> lastLoad_{0.0} ;
+    std::atomic<double> peakLoad_{0.0} ;
+    std::array<std::atomic<uint64_t>, N_BUCKETS> histogram_{} ;
+
+    // accumulated since the last sampleHistory(), swapped out by the reader
+    std::atomic<uint64_t> intervalBusyNs_{0} ;
+    std::atomic<uint64_t> intervalBudgetNs_{0} ;
+    std::atomic<double> intervalMaxLoad_{0.0} ;
+
+    // reader side
+    mutable std::mutex historyMutex_ ;
+    std::vector<Interval> history_ ;
+    size_t historyHead_ = 0 ;
+    uint64_t lastBlocks_ = 0 ;
+    uint64_t lastXruns_ = 0 ;
+    uint64_t lastLate_ = 0 ;
+    std::chrono::steady_clock::time_point created_ = std::chrono::steady_clock::now() ;
+
+public:
+    EngineStats() = default ;
+    EngineStats(const EngineStats&) = delete ;
+    EngineStats& operator=(const EngineStats&) = delete ;
+
+    // rate of the stream the callback feeds, sets the time budget of a block
+    void setSampleRate(double rate){
+        sampleRate_.store(rate, std::memory_order_relaxed);
+    }
+
+    // ---------------- audio thread ----------------
+
+    void recordBlock(uint64_t ns, unsigned int nFrames, bool underflow){
+        uint64_t budget = static_cast<uint64_t>(nFrames * 1e9 / sampleRate_.load(std::memory_order_relaxed));
+        double load = budget > 0 ? static_cast<double>(ns) / budget : 0.0 ;
+
+        blocks_.fetch_add(1, std::memory_order_relaxed);
+        if ( underflow ) xruns_.fetch_add(1, std::memory_order_relaxed);
+        if ( ns > budget ) late_.fetch_add(1, std::memory_order_relaxed);
+        busyNs_.fetch_add(ns, std::memory_order_relaxed);
+        budgetNs_.fetch_add(budget, std::memory_order_relaxed);
+        intervalBusyNs_.fetch_add(ns, std::memory_order_relaxed);
+        intervalBudgetNs_.fetch_add(budget, std::memory_order_relaxed);
+
+        storeMin(minNs_, ns);
+        storeMax(maxNs_, ns);
+        lastLoad_.store(load, std::memory_order_relaxed);
+        storeMax(peakLoad_, load);
+        storeMax(intervalMaxLoad_, load);
+
+        histogram_[bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // ---------------- other threads ----------------
+
+    double getLoad() const {
+        return lastLoad_.load(std::memory_order_relaxed);
+    }
+
+    double getAverageLoad() const {
+        uint64_t budget = budgetNs_.load(std::memory_order_relaxed);
+        return budget > 0 ? static_cast<double>(busyNs_.load(std::memory_order_relaxed)) / budget : 0.0 ;
+    }
+
+    uint64_t getXruns() const {
+        return xruns_.load(std::memory_order_relaxed);
+    }
+
+    // close the current interval and append it to the rolling history
+    void sampleHistory(){
+        Interval entry ;
+        entry.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - created_).count();
+        uint64_t busy = intervalBusyNs_.exchange(0, std::memory_order_relaxed);
+        uint64_t budget = intervalBudgetNs_.exchange(0, std::memory_order_relaxed);
+        entry.meanLoad = budget > 0 ? static_cast<double>(busy) / budget : 0.0 ;
+        entry.maxLoad = intervalMaxLoad_.exchange(0.0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(historyMutex_);
+        uint64_t blocks = blocks_.load(std::memory_order_relaxed);
+        uint64_t xruns = xruns_.load(std::memory_order_relaxed);
+        uint64_t late = late_.load(std::memory_order_relaxed);
+        entry.blocks = blocks - std::min(blocks, lastBlocks_);
+        entry.xruns = xruns - std::min(xruns, lastXruns_);
+        entry.late = late - std::min(late, lastLate_);
+        lastBlocks_ = blocks ;
+        lastXruns_ = xruns ;
+        lastLate_ = late ;
+
+        if ( history_.size() < HISTORY_SIZE ){
+            history_.push_back(entry);
+        } else {
+            history_[historyHead_] = entry ;
+            historyHead_ = ( historyHead_ + 1 ) % HISTORY_SIZE ;
+        }
+    }
+
+    // zero every counter, a block recorded concurrently may be partially kept
+    void reset(){
+        blocks_.store(0, std::memory_order_relaxed);
+        xruns_.store(0, std::memory_order_relaxed);
+        late_.store(0, std::memory_order_relaxed);
+        busyNs_.store(0, std::memory_order_relaxed);
+        budgetNs_.store(0, std::memory_order_relaxed);
+        minNs_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        maxNs_.store(0, std::memory_order_relaxed);
+        lastLoad_.store(0.0, std::memory_order_relaxed);
+        peakLoad_.store(0.0, std::memory_order_relaxed);
+        for ( auto& count : histogram_ ) count.store(0, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(historyMutex_);
+        history_.clear();
+        historyHead_ = 0 ;
+        lastBlocks_ = 0 ;
+        lastXruns_ = 0 ;
+        lastLate_ = 0 ;
+    }
+
+    json describe() const {
+        uint64_t blocks = blocks_.load(std::memory_order_relaxed);
+        uint64_t minNs = minNs_.load(std::memory_order_relaxed);
+
+        json histogram = json::array();
+        for ( size_t k = 0 ; k < N_BUCKETS ; ++k ){
+            json entry = {{"count", histogram_[k].load(std::memory_order_relaxed)}};
+            entry["upperUs"] = k + 1 < N_BUCKETS ? json(uint64_t{1} << k) : json(nullptr) ;
+            histogram.push_back(entry);
+        }
+
+        json history = json::array();
+        {
+            std::lock_guard<std::mutex> lock(historyMutex_);
+            for ( size_t i = 0 ; i < history_.size() ; ++i ){
+                const Interval& entry = history_[( historyHead_ + i ) % history_.size()] ;
+                history.push_back({
+                    {"time", entry.time},
+                    {"blocks", entry.blocks},
+                    {"xruns", entry.xruns},
+                    {"lateBlocks", entry.late},
+                    {"meanLoad", entry.meanLoad},
+                    {"maxLoad", entry.maxLoad}
+                });
+            }
+        }
+
+        return {
+            {"sampleRate", sampleRate_.load(std::memory_order_relaxed)},
+            {"blocks", blocks},
+            {"xruns", xruns_.load(std::memory_order_relaxed)},
+            {"lateBlocks", late_.load(std::memory_order_relaxed)},
+            {"load", getLoad()},
+            {"meanLoad", getAverageLoad()},
+            {"peakLoad", peakLoad_.load(std::memory_order_relaxed)},
+            {"blockMinUs", blocks > 0 ? minNs / 1e3 : 0.0},
+            {"blockMeanUs", blocks > 0 ? busyNs_.load(std::memory_order_relaxed) / 1e3 / blocks : 0.0},
+            {"blockMaxUs", maxNs_.load(std::memory_order_relaxed) / 1e3},
+            {"histogram", histogram},
+            {"history", history}
+        };
+    }
+
+private:
+    static size_t bucket(uint64_t ns){
+        return std::min<size_t>(std::bit_width(ns / 1000), N_BUCKETS - 1);
+    }
+
+    template <typename T>
+    static void storeMax(std::atomic<T>& target, T value){
+        T current = target.load(std::memory_order_relaxed);
+        while ( value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed) );
+    }
+
+    template <typename T>
+    static void storeMin(std::atomic<T>& target, T value){
+        T current = target.load(std::memory_order_relaxed);
+        while ( value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed) );
+    }
+};
+
+#endif // __ENGINE_STATS_HPP_
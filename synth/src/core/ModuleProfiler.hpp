@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MODULE_PROFILER_HPP_
+#define __MODULE_PROFILER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief execution time of one component, kept on the component itself
+ *
+ * The audio thread accumulates raw ticks while a profiling window is open and turns
+ * them into loads when the window closes. Loads are the share of the realtime budget
+ * spent, so 0.1 means the component alone uses a tenth of the audio thread.
+ */
+struct ComponentProfile {
+    // audio thread, ticks accumulated over the open window
+    uint64_t processTicks = 0 ;
+    uint64_t modulationTicks = 0 ;
+    uint64_t window = 0 ; // last window this profile was closed for
+
+    // published at the end of each window
+    std::atomic<double> processLoad{0.0} ;
+    std::atomic<double> modulationLoad{0.0} ;
+    std::atomic<uint64_t> published{0} ; // id of the window the loads belong to
+};
+
+/**
+ * @brief optional per component timing of the audio thread
+ *
+ * When disabled the only cost is one branch per block, which selects the untimed
+ * processing loop. When enabled every processed module and every parameter update
+ * is timed with the cheapest monotonic counter available (the TSC on x86), and the
+ * counts are converted to time once per window against steady_clock.
+ *
+ * The first window after profiling is switched on is discarded, it holds whatever
+ * was left over from the last time profiling ran.
+ */
+class ModuleProfiler {
+public:
+    static constexpr double WINDOW_SECONDS = 1.0 ; // of rendered audio
+
+private:
+    std::atomic<bool> enabled_{false} ;
+    std::atomic<uint64_t> lastWindow_{0} ; // most recently published window
+
+    // audio thread
+    bool open_ = false ;
+    bool discard_ = false ;
+    uint64_t windowId_ = 0 ;
+    double windowFrames_ = 0 ;
+    uint64_t startTicks_ = 0 ;
+    std::chrono::steady_clock::time_point startTime_ ;
+
+public:
+    ModuleProfiler() = default ;
+    ModuleProfiler(const ModuleProfiler&) = delete ;
+    ModuleProfiler& operator=(const ModuleProfiler&) = delete ;
+
+    static uint64_t ticks(){
+    #if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+    #else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    #endif
+    }
+
+    void setEnabled(bool enabled){
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // loads on profiles whose published id differs from this are stale
+    uint64_t getLastWindow() const {
+        return lastWindow_.load(std::memory_order_relaxed);
+    }
+
+    // ---------------- audio thread ----------------
+
+    // whether the coming block is profiled
+    bool beginBlock(){
+        if ( !enabled_.load(std::memory_order_relaxed) ){
+            open_ = false ;
+            return false ;
+        }
+        if ( !open_ ) openWindow(true);
+        return true ;
+    }
+
+    /**
+     * @brief count a profiled block, and close the window once it covers enough audio
+     *
+     * @param forEachProfile calls its argument with the profile of every scheduled component
+     */
+    template <typename F>
+    void endBlock(size_t nFrames, double sampleRate, F&& forEachProfile){
+        windowFrames_ += nFrames ;
+        if ( windowFrames_ < WINDOW_SECONDS * sampleRate ) return ;
+
+        double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime_).count();
+        uint64_t elapsedTicks = ticks() - startTicks_ ;
+        double nsPerTick = elapsedTicks > 0 ? elapsedNs / elapsedTicks : 1.0 ;
+        double scale = nsPerTick / ( windowFrames_ / sampleRate * 1e9 );
+
+        uint64_t id = ++windowId_ ;
+        bool publish = !discard_ ;
+        forEachProfile([id, scale, publish](ComponentProfile& profile){
+            if ( profile.window == id ) return ; // reachable through more than one list
+            profile.window = id ;
+            if ( publish ){
+                profile.processLoad.store(profile.processTicks * scale, std::memory_order_relaxed);
+                profile.modulationLoad.store(profile.modulationTicks * scale, std::memory_order_relaxed);
+                profile.published.store(id, std::memory_order_relaxed);
+            }
+            profile.processTicks = 0 ;
+            profile.modulationTicks = 0 ;
+        });
+        if ( publish ) lastWindow_.store(id, std::memory_order_relaxed);
+
+        openWindow(false);
+    }
+
+private:
+    void openWindow(bool discard){
+        open_ = true ;
+        discard_ = discard ;
+        windowFrames_ = 0 ;
+        startTicks_ = ticks();
+        startTime_ = std::chrono::steady_clock::now();
+    }
+};
+
+#endif // __MODULE_PROFILER_HPP_
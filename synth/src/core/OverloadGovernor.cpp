@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "core/OverloadGovernor.hpp"
+#include "config/Config.hpp"
+
+#include <algorithm>
+
+void OverloadGovernor::configure(){
+    setEnabled(Config::get<bool>("governor.enabled").value_or(false));
+    raiseLoad_ = Config::get<double>("governor.raise_load").value_or(0.85);
+    lowerLoad_ = std::min(raiseLoad_, Config::get<double>("governor.lower_load").value_or(0.6));
+    raiseBlocks_ = std::max<size_t>(1, Config::get<size_t>("governor.raise_blocks").value_or(4));
+    lowerBlocks_ = std::max<size_t>(1, Config::get<size_t>("governor.lower_blocks").value_or(400));
+    voiceLimit_ = std::max<size_t>(1, Config::get<size_t>("governor.voice_limit").value_or(8));
+    controlInterval_ = std::max<size_t>(1, Config::get<size_t>("governor.control_interval").value_or(16));
+    coefficientInterval_ = std::max<size_t>(1, Config::get<size_t>("governor.coefficient_interval").value_or(64));
+}
+
+const char* OverloadGovernor::getLevelName(Level level){
+    switch ( level ){
+        case FULL: return "full" ;
+        case STEAL_VOICES: return "steal_voices" ;
+        case CONTROL_RATE: return "control_rate" ;
+        case FILTER_COEFFICIENTS: return "filter_coefficients" ;
+        case BYPASS_OPTIONAL: return "bypass_optional" ;
+        default: return "unknown" ;
+    }
+}
+
+bool OverloadGovernor::update(double load, bool underflow){
+    Level level = getLevel();
+    blocks_[level].fetch_add(1, std::memory_order_relaxed);
+
+    if ( !isEnabled() ){
+        if ( level == FULL ) return false ;
+        setLevel(FULL);
+        return true ;
+    }
+
+    if ( underflow || load >= raiseLoad_ ){
+        under_ = 0 ;
+        if ( level + 1 < N_LEVELS && ( underflow || ++over_ >= raiseBlocks_ ) ){
+            setLevel(static_cast<Level>(level + 1));
+            raised_.fetch_add(1, std::memory_order_relaxed);
+            return true ;
+        }
+    } else if ( load < lowerLoad_ ){
+        over_ = 0 ;
+        if ( level > FULL && ++under_ >= lowerBlocks_ ){
+            setLevel(static_cast<Level>(level - 1));
+            lowered_.fetch_add(1, std::memory_order_relaxed);
+            return true ;
+        }
+    } else {
+        // between the thresholds, neither direction builds up
+        over_ = 0 ;
+        under_ = 0 ;
+    }
+    return false ;
+}
+
+SignalController::Quality OverloadGovernor::getQuality() const {
+    Level level = getLevel();
+    SignalController::Quality quality ;
+    if ( level >= STEAL_VOICES ) quality.voiceLimit = voiceLimit_ ;
+    if ( level >= CONTROL_RATE ) quality.controlInterval = controlInterval_ ;
+    if ( level >= FILTER_COEFFICIENTS ) quality.coefficientInterval = coefficientInterval_ ;
+    if ( level >= BYPASS_OPTIONAL ) quality.bypassOptional = true ;
+    return quality ;
+}
+
+json OverloadGovernor::status() const {
+    Level level = getLevel();
+    json blocks = json::object();
+    for ( size_t l = 0 ; l < N_LEVELS ; ++l ){
+        blocks[getLevelName(static_cast<Level>(l))] = blocks_[l].load(std::memory_order_relaxed);
+    }
+
+    return {
+        {"enabled", isEnabled()},
+        {"level", static_cast<int>(level)},
+        {"levelName", getLevelName(level)},
+        {"raised", raised_.load(std::memory_order_relaxed)},
+        {"lowered", lowered_.load(std::memory_order_relaxed)},
+        {"blocksAtLevel", blocks},
+        {"raiseLoad", raiseLoad_},
+        {"lowerLoad", lowerLoad_},
+        {"raiseBlocks", raiseBlocks_},
+        {"lowerBlocks", lowerBlocks_},
+        {"voiceLimit", voiceLimit_},
+        {"controlInterval", controlInterval_},
+        {"coefficientInterval", coefficientInterval_}
+    };
+}
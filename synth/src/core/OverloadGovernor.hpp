@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __OVERLOAD_GOVERNOR_HPP_
+#define __OVERLOAD_GOVERNOR_HPP_
+
+#include "signal/SignalController.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+/**
+ * @brief trades sound quality for headroom when the audio callback nears its deadline
+ *
+ * Configured under "governor". The audio thread hands the load of every block to update().
+ * After raise_blocks blocks in a row at or above raise_load, or right away on an xrun,
+ * the governor moves up one level. It steps back down one level after lower_blocks blocks
+ * in a row under lower_load. Levels add up, each one keeps what the ones below it shed:
+ *
+ *   1. polyphonic modules keep at most voice_limit voices, the quietest are cut
+ *   2. modulation only updates every control_interval frames, except where a signal module
+ *      is the modulator
+ *   3. filters refresh their coefficients at most every coefficient_interval frames
+ *   4. modules marked optional pass their input through unprocessed
+ */
+class OverloadGovernor {
+public:
+    enum Level : uint8_t {
+        FULL,
+        STEAL_VOICES,
+        CONTROL_RATE,
+        FILTER_COEFFICIENTS,
+        BYPASS_OPTIONAL,
+        N_LEVELS
+    };
+
+private:
+    // configuration, set before the engine starts
+    double raiseLoad_ = 0.85 ;
+    double lowerLoad_ = 0.6 ;
+    size_t raiseBlocks_ = 4 ;
+    size_t lowerBlocks_ = 400 ;
+    size_t voiceLimit_ = 8 ;
+    size_t controlInterval_ = 16 ;
+    size_t coefficientInterval_ = 64 ;
+
+    std::atomic<bool> enabled_{false} ;
+    std::atomic<uint8_t> level_{FULL} ;
+    std::atomic<uint64_t> raised_{0} ;
+    std::atomic<uint64_t> lowered_{0} ;
+    std::array<std::atomic<uint64_t>, N_LEVELS> blocks_{} ; // blocks rendered at each level
+
+    // audio thread
+    size_t over_ = 0 ;  // consecutive blocks at or above raiseLoad_
+    size_t under_ = 0 ; // consecutive blocks under lowerLoad_
+
+public:
+    OverloadGovernor() = default ;
+    OverloadGovernor(const OverloadGovernor&) = delete ;
+    OverloadGovernor& operator=(const OverloadGovernor&) = delete ;
+
+    // read the "governor" section of the config
+    void configure();
+
+    // while disabled the next update returns to full quality
+    void setEnabled(bool enabled){
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    Level getLevel() const {
+        return static_cast<Level>(level_.load(std::memory_order_relaxed));
+    }
+
+    static const char* getLevelName(Level level);
+
+    // ---------------- audio thread ----------------
+
+    /**
+     * @brief account for a finished block
+     *
+     * @return true if the level changed, the signal controller then needs getQuality()
+     */
+    bool update(double load, bool underflow);
+
+    // what the signal controller leaves out at the current level
+    SignalController::Quality getQuality() const ;
+
+    // ---------------- other threads ----------------
+
+    json status() const ;
+
+private:
+    void setLevel(Level level){
+        level_.store(level, std::memory_order_relaxed);
+        over_ = 0 ;
+        under_ = 0 ;
+    }
+};
+
+#endif // __OVERLOAD_GOVERNOR_HPP_
@@ -0,0 +1,359 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PARAMETER_CHANGE_QUEUE_HPP_
+#define __PARAMETER_CHANGE_QUEUE_HPP_
+
+#include "containers/MPSCQueue.hpp"
+#include "params/ParameterChange.hpp"
+#include "params/ParameterMap.hpp"
+#include "core/ComponentManager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief routes parameter writes from API threads to the audio thread
+ * 
+ * While an audio callback is running, changes are pushed into a lock-free MPSC queue and 
+ * applied by the audio thread at the start of the next block (or at their frame offset
+ * within it). The audio thread finds components through the processing plan's table, never
+ * through the component manager. When no callback is consuming the queue, changes are
+ * applied directly.
+ * 
+ * Changes submitted inside a Batch are collected and handed over as one group, together
+ * with any collection snapshots published meanwhile, so they land at a single block boundary.
+ */
+class ParameterChangeQueue {
+public:
+    // furthest a change may be scheduled ahead: one block of the largest size the engine accepts
+    static constexpr uint32_t MAX_FRAME_OFFSET = 4096 ;
+
+private:
+    static constexpr size_t MAX_PENDING = 512 ;
+
+    ComponentManager* componentManager_ ;
+    MPSCQueue<ParameterChange> queue_ ;
+
+    std::mutex directMutex_ ; // orders direct application against realtime hand-over, never taken by the audio thread
+    std::atomic<bool> realtime_{false} ;
+    std::atomic<bool> discard_{false} ;   // drop everything pending at the next collect
+
+    // owned by the audio thread
+    std::array<ParameterChange, MAX_PENDING> pending_ ;
+    size_t nPending_ = 0 ;
+    size_t nextPending_ = 0 ;
+    std::vector<ParameterChange>* batch_ = nullptr ; // taken over, applied once the plan is adopted
+    bool syncCollections_ = true ;
+    const std::vector<BaseComponent*>* components_ = nullptr ; // adopted plan's components by id
+    uint32_t blockFrames_ = 0 ;
+
+    // batch hand-over
+    std::mutex batchMutex_ ;                      // one batch in flight at a time, never taken by the audio thread
+    std::atomic<bool> holdCollections_{false} ;   // audio thread doesn't adopt collection snapshots while set
+    std::atomic<std::vector<ParameterChange>*> pendingBatch_{nullptr} ;
+    std::atomic<bool> batchApplied_{false} ;
+    std::atomic<uint64_t> blocks_{0} ;
+    static inline thread_local std::vector<ParameterChange>* collecting_ = nullptr ;
+
+public:
+    ParameterChangeQueue(ComponentManager* componentManager, size_t capacity = 4096):
+        componentManager_(componentManager),
+        queue_(capacity)
+    {}
+
+    /**
+     * @brief submit a change from any non-audio thread. Frame offsets are clamped to MAX_FRAME_OFFSET.
+     * 
+     * @return false if the queue is full
+     */
+    bool submit(ParameterChange change){
+        change.frameOffset = std::min(change.frameOffset, MAX_FRAME_OFFSET);
+        if ( collecting_ ){
+            collecting_->push_back(change);
+            return true ;
+        }
+
+        if ( realtime_.load(std::memory_order_acquire) ) return queue_.push(change);
+
+        std::lock_guard<std::mutex> lock(directMutex_);
+        if ( realtime_.load(std::memory_order_acquire) ) return queue_.push(change);
+
+        applyAll();
+        apply(change);
+        return true ;
+    }
+
+    /**
+     * @brief set whether an audio callback is consuming the queue. When switching off, the
+     * stream must already be stopped; anything still queued is applied immediately.
+     */
+    void setRealtime(bool realtime){
+        std::lock_guard<std::mutex> lock(directMutex_);
+        if ( !realtime ){
+            applyAll();
+            if ( !batch_ ) batch_ = pendingBatch_.exchange(nullptr, std::memory_order_acq_rel);
+            if ( batch_ ){
+                for ( const auto& change : *batch_ ) apply(change);
+                batch_ = nullptr ;
+                batchApplied_.store(true, std::memory_order_release);
+            }
+        }
+        realtime_.store(realtime, std::memory_order_release);
+    }
+
+    /**
+     * @brief scope in which every change submitted by the calling thread is applied atomically
+     * 
+     * On construction the audio thread stops adopting collection snapshots; on destruction the
+     * collected changes are handed over and applied, along with the held snapshots, at the
+     * start of one block. Blocks the calling thread for a few audio blocks at most. Without a
+     * running callback the changes are applied directly when the scope ends.
+     */
+    class Batch {
+    private:
+        ParameterChangeQueue& queue_ ;
+        std::unique_lock<std::mutex> lock_ ;
+        std::vector<ParameterChange> changes_ ;
+        bool held_ = false ;
+
+    public:
+        Batch(ParameterChangeQueue& queue):
+            queue_(queue),
+            lock_(queue.batchMutex_)
+        {
+            changes_.reserve(256);
+            collecting_ = &changes_ ;
+            if ( !queue_.realtime_.load(std::memory_order_acquire) ) return ;
+
+            queue_.holdCollections_.store(true);
+            queue_.waitForBlock();
+            held_ = true ;
+        }
+
+        ~Batch(){
+            collecting_ = nullptr ;
+            queue_.handOver(changes_);
+            if ( held_ ) queue_.holdCollections_.store(false);
+        }
+
+        // drop every change collected so far, e.g. when the edits they belong to are rolled back
+        void cancel(){
+            changes_.clear();
+        }
+
+        Batch(const Batch&) = delete ;
+        Batch& operator=(const Batch&) = delete ;
+    };
+
+    // ---------------- audio thread ----------------
+
+    /**
+     * @brief take over the pending batch and drain the queue
+     * 
+     * Called before the block's processing plan is adopted. A component is in a published plan
+     * before any change for it can be submitted, so the adopted plan knows every component
+     * the changes taken here refer to.
+     */
+    void collect(){
+        syncCollections_ = !holdCollections_.load();
+        batch_ = pendingBatch_.exchange(nullptr, std::memory_order_acq_rel);
+
+        ParameterChange change ;
+        if ( discard_.exchange(false, std::memory_order_acq_rel) ){
+            nPending_ = 0 ;
+            while ( queue_.pop(change) ){}
+        }
+
+        while ( nPending_ < MAX_PENDING && queue_.pop(change) ){
+            pending_[nPending_++] = change ;
+        }
+
+        // insertion sort: stable (submission order is kept per frame) and allocation free
+        for ( size_t i = 1 ; i < nPending_ ; ++i ){
+            ParameterChange c = pending_[i] ;
+            size_t j = i ;
+            while ( j > 0 && pending_[j - 1].frameOffset > c.frameOffset ){
+                pending_[j] = pending_[j - 1] ;
+                --j ;
+            }
+            pending_[j] = c ;
+        }
+        nextPending_ = 0 ;
+    }
+
+    /**
+     * @brief apply the collected batch and every change scheduled at the first frame of the block
+     * 
+     * @param components the adopted plan's components by id. Changes for components it
+     * doesn't hold (removed meanwhile) are dropped.
+     * @param nFrames frames in the block
+     * @return whether collection snapshots may be adopted during this block
+     */
+    bool beginBlock(const std::vector<BaseComponent*>& components, uint32_t nFrames){
+        components_ = &components ;
+        blockFrames_ = nFrames ;
+        bool syncCollections = syncCollections_ ;
+        if ( batch_ ){
+            for ( const auto& c : *batch_ ) applyPlanned(c);
+            batch_ = nullptr ;
+            batchApplied_.store(true, std::memory_order_release);
+            syncCollections = true ;
+        }
+
+        applyUntil(0);
+        return syncCollections ;
+    }
+
+    inline void applyUntil(uint32_t frame){
+        while ( nextPending_ < nPending_ && pending_[nextPending_].frameOffset <= frame ){
+            applyPlanned(pending_[nextPending_++], frame);
+        }
+    }
+
+    /**
+     * @brief carry changes scheduled past the end of this block over to the next one
+     */
+    void endBlock(uint32_t nFrames){
+        size_t remaining = nPending_ - nextPending_ ;
+        for ( size_t i = 0 ; i < remaining ; ++i ){
+            pending_[i] = pending_[nextPending_ + i] ;
+            pending_[i].frameOffset -= nFrames ;
+        }
+        nPending_ = remaining ;
+        nextPending_ = 0 ;
+        blocks_.fetch_add(1, std::memory_order_release);
+    }
+
+    // ---------------- API threads ----------------
+
+    /**
+     * @brief wait until no block that started before this call is still in progress.
+     * Returns immediately when no audio callback is running.
+     */
+    void waitForBlock(){
+        uint64_t start = blocks_.load(std::memory_order_acquire);
+        while ( realtime_.load(std::memory_order_acquire) && blocks_.load(std::memory_order_acquire) == start ){
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+
+    /**
+     * @brief drop every change still waiting in the queue or scheduled for a later block,
+     * e.g. when component ids start over. Blocks for one audio block at most.
+     */
+    void discardPending(){
+        discard_.store(true, std::memory_order_release);
+        while ( true ){
+            while ( realtime_.load(std::memory_order_acquire) && discard_.load(std::memory_order_acquire) ){
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+            }
+
+            std::lock_guard<std::mutex> lock(directMutex_);
+            if ( realtime_.load(std::memory_order_acquire) ){
+                if ( !discard_.load(std::memory_order_acquire) ) return ;
+                continue ; // stream restarted before the flag was picked up
+            }
+            if ( discard_.exchange(false, std::memory_order_acq_rel) ){
+                nPending_ = 0 ;
+                nextPending_ = 0 ;
+                ParameterChange change ;
+                while ( queue_.pop(change) ){}
+            }
+            return ;
+        }
+    }
+
+private:
+
+    // apply a finished batch: directly while no callback runs, otherwise at the start of one block
+    void handOver(std::vector<ParameterChange>& changes){
+        {
+            std::lock_guard<std::mutex> lock(directMutex_);
+            if ( !realtime_.load(std::memory_order_acquire) ){
+                applyAll();
+                for ( const auto& change : changes ) apply(change);
+                return ;
+            }
+        }
+
+        batchApplied_.store(false);
+        pendingBatch_.store(&changes, std::memory_order_release);
+        while ( !batchApplied_.load(std::memory_order_acquire) ){
+            if ( !realtime_.load(std::memory_order_acquire) ){
+                // stream stopped before the batch was picked up
+                std::lock_guard<std::mutex> lock(directMutex_);
+                if ( auto* batch = pendingBatch_.exchange(nullptr, std::memory_order_acq_rel) ){
+                    for ( const auto& change : *batch ) apply(change);
+                }
+                break ;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+
+    void applyAll(){
+        for ( size_t i = nextPending_ ; i < nPending_ ; ++i ) apply(pending_[i]);
+        nPending_ = 0 ;
+        nextPending_ = 0 ;
+
+        ParameterChange change ;
+        while ( queue_.pop(change) ) apply(change);
+    }
+
+    // audio thread
+    void applyPlanned(const ParameterChange& change, uint32_t frame = 0){
+        size_t id = static_cast<size_t>(change.componentId);
+        if ( change.componentId < 0 || id >= components_->size() ) return ;
+        BaseComponent* c = (*components_)[id] ;
+        apply(change, c);
+
+        // smoothing ramps are laid out for the whole block at its first frame
+        if ( c && frame > 0 && frame < blockFrames_ && change.type == ParameterChangeType::VALUE ){
+            c->getParameters()->restartSmoothing(change.parameter, blockFrames_ - frame);
+        }
+    }
+
+    // API threads, while no callback runs
+    void apply(const ParameterChange& change){
+        apply(change, componentManager_->getRaw(change.componentId));
+    }
+
+    void apply(const ParameterChange& change, BaseComponent* c){
+        if ( !c ) return ;
+
+        switch(change.type){
+        case ParameterChangeType::VALUE:
+        case ParameterChangeType::JUMP:
+            c->getParameters()->setTargetDispatch(change.parameter, change.value, change.type == ParameterChangeType::VALUE);
+            break ;
+        case ParameterChangeType::DEPTH:
+            c->setParameterDepth(change.parameter, change.value);
+            break ;
+        case ParameterChangeType::STRATEGY:
+            c->setParameterModulationStrategy(change.parameter, static_cast<ModulationStrategy>(change.value));
+            break ;
+        }
+    }
+};
+
+#endif // __PARAMETER_CHANGE_QUEUE_HPP_
@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PROBE_TABLE_HPP_
+#define __PROBE_TABLE_HPP_
+
+#include "containers/SnapshotExchange.hpp"
+#include "core/BaseComponent.hpp"
+#include "core/BaseModule.hpp"
+#include "params/ParameterMap.hpp"
+#include "types/ParameterType.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class ProbeKind : uint8_t {
+    PARAMETER, // instantaneous (modulated) parameter value
+    LEVEL,     // peak absolute output over the last block
+    RMS,       // rms output over the last block
+    VOICES     // active voice/note count
+};
+
+struct ProbeKey {
+    ComponentId componentId ;
+    ProbeKind kind ;
+    ParameterType parameter = ParameterType::N_PARAMETERS ;
+    size_t output = 0 ;
+
+    bool operator==(const ProbeKey& other) const {
+        return componentId == other.componentId && kind == other.kind && 
+               parameter == other.parameter && output == other.output ;
+    }
+};
+
+/**
+ * @brief a single observed value, written by the audio thread once per block
+ */
+struct Probe {
+    ProbeKey key ;
+    BaseComponent* component ;
+    BaseModule* module ; // null unless the probe reads output buffers
+    std::atomic<float> value{0.0f} ;
+    size_t refs = 0 ; // subscriptions sharing this probe, writer side only
+};
+
+/**
+ * @brief set of probes sampled by the audio thread at the end of every block
+ * 
+ * Probes are shared between subscriptions with the same key. The writer publishes an
+ * immutable list of probes which the audio thread adopts at its next sample() call. Old
+ * lists (and the probes only they reference) are freed once the audio thread has moved
+ * past them, so a component can be removed after release() and one audio block.
+ */
+class ProbeTable {
+private:
+    using ProbeList = std::vector<std::shared_ptr<Probe>> ;
+
+    std::mutex writeMutex_ ;
+    std::vector<std::shared_ptr<Probe>> probes_ ;
+    SnapshotExchange<ProbeList> published_ ;
+
+    std::function<void()> onObserversChanged_ ;
+
+public:
+    ProbeTable() = default ;
+    ProbeTable(const ProbeTable&) = delete ;
+    ProbeTable& operator=(const ProbeTable&) = delete ;
+
+    // ---------------- audio thread ----------------
+
+    void sample(size_t nFrames){
+        const ProbeList* probes = published_.acquire();
+        if ( !probes ) return ;
+
+        for ( const auto& probe : *probes ){
+            probe->value.store(measure(*probe, nFrames), std::memory_order_relaxed);
+        }
+    }
+
+    // the audio thread stopped, only the latest list is kept until it samples again
+    void detach(){
+        published_.detach();
+    }
+
+    // ---------------- API threads ----------------
+
+    // called after a module gains its first or loses its last output probe
+    void setObserverHook(std::function<void()> hook){
+        onObserversChanged_ = std::move(hook);
+    }
+
+    /**
+     * @brief find or create the probe for a key
+     * 
+     * @return nullptr if the component doesn't exist or can't provide the key
+     */
+    std::shared_ptr<Probe> acquire(const ProbeKey& key, BaseComponent* component){
+        std::unique_lock<std::mutex> lock(writeMutex_);
+        auto it = std::find_if(probes_.begin(), probes_.end(), [&](const auto& p){ return p->key == key ; });
+        if ( it != probes_.end() ){
+            (*it)->refs++ ;
+            return *it ;
+        }
+
+        if ( !component ) return nullptr ;
+        BaseModule* module = nullptr ;
+        switch(key.kind){
+        case ProbeKind::PARAMETER:
+            if ( !component->getParameters()->getParameter(key.parameter) ) return nullptr ;
+            break ;
+        case ProbeKind::LEVEL:
+        case ProbeKind::RMS:
+            module = dynamic_cast<BaseModule*>(component);
+            if ( !module || key.output >= module->getNumOutputs() ) return nullptr ;
+            break ;
+        case ProbeKind::VOICES:
+            break ;
+        }
+
+        auto probe = std::make_shared<Probe>();
+        probe->key = key ;
+        probe->component = component ;
+        probe->module = module ;
+        probe->refs = 1 ;
+        probes_.push_back(probe);
+        publish();
+
+        if ( module ){
+            module->addObserver();
+            lock.unlock();
+            if ( onObserversChanged_ ) onObserversChanged_();
+        }
+        return probe ;
+    }
+
+    void release(const std::shared_ptr<Probe>& probe){
+        std::unique_lock<std::mutex> lock(writeMutex_);
+        if ( --probe->refs > 0 ) return ;
+        probes_.erase(std::remove(probes_.begin(), probes_.end(), probe), probes_.end());
+        publish();
+
+        if ( probe->module ){
+            probe->module->removeObserver();
+            lock.unlock();
+            if ( onObserversChanged_ ) onObserversChanged_();
+        }
+    }
+
+private:
+    void publish(){
+        published_.publish(probes_);
+    }
+
+    static float measure(const Probe& probe, size_t nFrames){
+        switch(probe.key.kind){
+        case ProbeKind::PARAMETER:
+            return static_cast<float>(probe.component->getParameters()->getInstantaneousDispatch(probe.key.parameter));
+        case ProbeKind::VOICES:
+            return static_cast<float>(probe.component->getActiveVoices());
+        case ProbeKind::LEVEL:
+        case ProbeKind::RMS:
+        {
+            // the last nFrames samples, ending at the module's write position
+            const double* data = probe.module->data(probe.key.output);
+            size_t size = probe.module->size() ;
+            size_t n = std::min(nFrames, size);
+            if ( n == 0 ) return 0.0f ;
+            size_t j = ( probe.module->getBufferIndex() + 1 + size - n ) % size ;
+            double acc = 0.0 ;
+            for ( size_t i = 0 ; i < n ; ++i ){
+                if ( probe.key.kind == ProbeKind::LEVEL ) acc = std::max(acc, std::fabs(data[j]));
+                else acc += data[j] * data[j] ;
+                if ( ++j == size ) j = 0 ;
+            }
+            if ( probe.key.kind == ProbeKind::LEVEL ) return static_cast<float>(acc);
+            return static_cast<float>(std::sqrt(acc / n));
+        }
+        }
+        return 0.0f ;
+    }
+};
+
+#endif // __PROBE_TABLE_HPP_
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "core/RealtimeMode.hpp"
+#include "config/Config.hpp"
+#include "dsp/Wavetable.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <spdlog/spdlog.h>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#define REALTIME_MODE_MXCSR
+#endif
+
+namespace {
+    json error(int code){
+        if ( code == 0 ) return nullptr ;
+        return std::strerror(code) ;
+    }
+
+    const char* policyName(int policy){
+        switch ( policy ){
+            case SCHED_FIFO: return "fifo" ;
+            case SCHED_RR: return "rr" ;
+            case SCHED_OTHER: return "other" ;
+            default: return "unknown" ;
+        }
+    }
+}
+
+void RealtimeMode::configure(){
+    enabled_ = Config::get<bool>("realtime.enabled").value_or(false);
+    lockMemory_ = Config::get<bool>("realtime.lock_memory").value_or(true);
+    flushDenormals_ = Config::get<bool>("realtime.flush_denormals").value_or(true);
+    priority_ = Config::get<int>("realtime.priority").value_or(80);
+    cpus_ = Config::get<std::vector<int>>("realtime.cpus").value_or(std::vector<int>{});
+}
+
+void RealtimeMode::apply(){
+    if ( !enabled_ || !lockMemory_ ) return ;
+
+    // locking future mappings too fails every later allocation once the limit is reached,
+    // so that is only asked for when there is no limit to reach
+    rlimit limit ;
+    bool unlimited = geteuid() == 0 || ( getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY );
+    int flags = unlimited ? MCL_CURRENT | MCL_FUTURE : MCL_CURRENT ;
+
+    if ( mlockall(flags) == 0 ){
+        memoryLocked_ = true ;
+        futureLocked_ = unlimited ;
+        memoryError_ = 0 ;
+        SPDLOG_INFO("Locked process memory{}.", unlimited ? ", including future allocations" : "");
+    } else {
+        memoryError_ = errno ;
+        SPDLOG_WARN("Could not lock process memory: {}", std::strerror(errno));
+    }
+
+    // the tables are generated on first use, make sure they exist and stay resident
+    Wavetable::generate();
+    wavetablesLocked_ = Wavetable::lock();
+}
+
+void RealtimeMode::prepareAudioThread(){
+    pending_.store(false, std::memory_order_relaxed);
+    pthread_t self = pthread_self();
+
+    if ( !cpus_.empty() ){
+        cpu_set_t set ;
+        CPU_ZERO(&set);
+        for ( int cpu : cpus_ ){
+            if ( cpu >= 0 && cpu < CPU_SETSIZE ) CPU_SET(cpu, &set);
+        }
+        affinityError_ = pthread_setaffinity_np(self, sizeof(set), &set);
+    }
+
+    sched_param param {} ;
+    param.sched_priority = priority_ ;
+    priorityError_ = pthread_setschedparam(self, SCHED_FIFO, &param);
+
+    int policy ;
+    if ( pthread_getschedparam(self, &policy, &param) == 0 ){
+        policy_ = policy ;
+        threadPriority_ = param.sched_priority ;
+    }
+
+#ifdef REALTIME_MODE_MXCSR
+    if ( flushDenormals_ ){
+        _mm_setcsr(_mm_getcsr() | 0x8040); // flush-to-zero (bit 15) and denormals-are-zero (bit 6)
+        denormalsFlushed_ = true ;
+    }
+#endif
+
+    prefaultStack();
+    prepared_.store(true, std::memory_order_release);
+}
+
+// the callback's deepest stack use then never faults in a fresh page
+[[gnu::noinline]] void RealtimeMode::prefaultStack(){
+    unsigned char stack[STACK_PREFAULT_BYTES] ;
+    volatile unsigned char* page = stack ;
+    for ( size_t i = 0 ; i < STACK_PREFAULT_BYTES ; i += 4096 ) page[i] = 0 ;
+}
+
+json RealtimeMode::status() const {
+    rusage usage {} ;
+    getrusage(RUSAGE_SELF, &usage);
+
+    json cpus = cpus_ ;
+    bool prepared = prepared_.load(std::memory_order_acquire);
+    return {
+        {"enabled", enabled_},
+        {"memory", {
+            {"requested", enabled_ && lockMemory_},
+            {"locked", memoryLocked_.load()},
+            {"future", futureLocked_.load()},
+            {"wavetables", wavetablesLocked_.load()},
+            {"error", error(memoryError_.load())}
+        }},
+        {"audioThread", {
+            {"prepared", prepared},
+            {"cpus", cpus},
+            {"affinityError", prepared ? error(affinityError_.load()) : nullptr},
+            {"policy", prepared ? json(policyName(policy_.load())) : json()},
+            {"priority", threadPriority_.load()},
+            {"requestedPriority", priority_},
+            {"priorityError", prepared ? error(priorityError_.load()) : nullptr},
+            {"denormalsFlushed", denormalsFlushed_.load()}
+        }},
+        {"pageFaults", {
+            {"minor", usage.ru_minflt},
+            {"major", usage.ru_majflt}
+        }}
+    };
+}
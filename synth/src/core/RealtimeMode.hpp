@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __REALTIME_MODE_HPP_
+#define __REALTIME_MODE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+/**
+ * @brief optional hardening of the process and the audio thread against page faults,
+ * core migration and denormal slowdowns
+ *
+ * Configured under "realtime". When enabled, apply() locks the process's memory and the
+ * wavetables when the engine starts, and the audio thread calls prepareAudioThread() at
+ * the start of the first callback of each stream. That pins it to the configured cores,
+ * switches it to SCHED_FIFO, sets flush-to-zero and denormals-are-zero and touches its
+ * stack. Each step may fail for lack of privileges, the outcome of every step is kept
+ * for status().
+ */
+class RealtimeMode {
+public:
+    static constexpr size_t STACK_PREFAULT_BYTES = 256 * 1024 ;
+
+private:
+    // configuration, set before the engine starts
+    bool enabled_ = false ;
+    bool lockMemory_ = true ;
+    bool flushDenormals_ = true ;
+    int priority_ = 80 ;
+    std::vector<int> cpus_ ;
+
+    // process, written by apply()
+    std::atomic<bool> memoryLocked_{false} ;
+    std::atomic<bool> futureLocked_{false} ;
+    std::atomic<int> memoryError_{0} ;
+    std::atomic<bool> wavetablesLocked_{false} ;
+
+    // audio thread, written once per stream by prepareAudioThread()
+    std::atomic<bool> pending_{false} ;
+    std::atomic<bool> prepared_{false} ;
+    std::atomic<int> affinityError_{0} ;
+    std::atomic<int> priorityError_{0} ;
+    std::atomic<int> policy_{-1} ;
+    std::atomic<int> threadPriority_{0} ;
+    std::atomic<bool> denormalsFlushed_{false} ;
+
+public:
+    RealtimeMode() = default ;
+    RealtimeMode(const RealtimeMode&) = delete ;
+    RealtimeMode& operator=(const RealtimeMode&) = delete ;
+
+    // read the "realtime" section of the config
+    void configure();
+
+    bool isEnabled() const {
+        return enabled_ ;
+    }
+
+    bool locksMemory() const {
+        return enabled_ && lockMemory_ ;
+    }
+
+    int getPriority() const {
+        return priority_ ;
+    }
+
+    // lock memory, call when the engine starts
+    void apply();
+
+    // the next callback prepares its thread, call before a stream starts
+    void arm(){
+        if ( enabled_ ) pending_.store(true, std::memory_order_release);
+    }
+
+    // ---------------- audio thread ----------------
+
+    bool isPending() const {
+        return pending_.load(std::memory_order_acquire);
+    }
+
+    // makes syscalls, call outside the realtime scope
+    void prepareAudioThread();
+
+    // ---------------- other threads ----------------
+
+    json status() const ;
+
+private:
+    static void prefaultStack();
+};
+
+#endif // __REALTIME_MODE_HPP_
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LATENCY_PROBE_HPP_
+#define __LATENCY_PROBE_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+/**
+ * @brief measures the time from a note-on arriving to the first block it is heard in
+ *
+ * The midi thread stamps note-ons as they arrive. A voice started for the stamped note
+ * watches its own output, and the first block in which it rises above THRESHOLD ends
+ * the measurement at the moment the callback hands that block to the device. Voices are
+ * watched before effects and envelopes, so a patch that is already sounding, or one
+ * whose output is quiet, does not hide the onset. One note is measured at a time,
+ * note-ons arriving while one is pending are not stamped. A note whose voice stays
+ * silent for a second, or that starts no voice, counts as missed.
+ *
+ * Latencies go into 1 ms buckets. The time the device itself takes to play out a block
+ * is reported separately as streamLatencyMs.
+ */
+class LatencyProbe {
+public:
+    static constexpr size_t N_BUCKETS = 100 ;     // [k, k+1) ms, the last bucket takes the rest
+    static constexpr double THRESHOLD = 1e-3 ;    // -60 dBFS
+    static constexpr uint64_t TIMEOUT_NS = 1000000000 ;
+    static constexpr uint64_t NOTE_MASK = 0x7F ;  // the low bits of a stamp carry its midi note
+
+private:
+    static inline std::atomic<LatencyProbe*> active_{nullptr} ;
+
+    std::atomic<bool> enabled_{true} ;
+    std::atomic<uint64_t> pending_{0} ; // stamp of the note being measured, 0 when idle
+
+    std::atomic<uint64_t> count_{0} ;
+    std::atomic<uint64_t> missed_{0} ;
+    std::atomic<uint64_t> sumNs_{0} ;
+    std::atomic<uint64_t> minNs_{std::numeric_limits<uint64_t>::max()} ;
+    std::atomic<uint64_t> maxNs_{0} ;
+    std::array<std::atomic<uint64_t>, N_BUCKETS> histogram_{} ;
+    std::atomic<double> streamLatencyMs_{0.0} ;
+
+    // audio thread
+    uint64_t heard_ = 0 ;    // stamp whose voice became audible in the current block
+
+public:
+    LatencyProbe() = default ;
+    LatencyProbe(const LatencyProbe&) = delete ;
+    LatencyProbe& operator=(const LatencyProbe&) = delete ;
+
+    static uint64_t now(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    void setEnabled(bool enabled){
+        enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool isEnabled() const {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // the probe voices report to
+    static LatencyProbe* active(){
+        return active_.load(std::memory_order_relaxed);
+    }
+
+    static void setActive(LatencyProbe* probe){
+        active_.store(probe, std::memory_order_relaxed);
+    }
+
+    // buffering between the callback and the speaker, as reported by the device
+    void setStreamLatency(double ms){
+        streamLatencyMs_.store(ms, std::memory_order_relaxed);
+    }
+
+    // ---------------- midi thread ----------------
+
+    void noteOn(uint64_t stamp, uint8_t note){
+        if ( !isEnabled() ) return ;
+        uint64_t idle = 0 ;
+        pending_.compare_exchange_strong(idle, (stamp & ~NOTE_MASK) | (note & NOTE_MASK), std::memory_order_relaxed);
+    }
+
+    // ---------------- audio thread ----------------
+
+    // a voice starts for note. Returns the stamp to report it heard with, 0 when the note
+    // is not being measured
+    uint64_t watch(uint8_t note) const {
+        if ( !isEnabled() ) return 0 ;
+        uint64_t stamp = pending_.load(std::memory_order_relaxed);
+        return stamp != 0 && (stamp & NOTE_MASK) == note ? stamp : 0 ;
+    }
+
+    // a watched voice produced its first sample above THRESHOLD
+    void heard(uint64_t stamp){
+        if ( stamp == pending_.load(std::memory_order_relaxed) ) heard_ = stamp ;
+    }
+
+    // the callback hands a block to the device
+    void endBlock(){
+        if ( !isEnabled() ) return ;
+        uint64_t stamp = pending_.load(std::memory_order_relaxed);
+        if ( stamp == 0 ) return ;
+
+        uint64_t elapsed = now() - (stamp & ~NOTE_MASK) ;
+        if ( heard_ == stamp ){
+            record(elapsed);
+            finish(stamp);
+        } else if ( elapsed > TIMEOUT_NS ){
+            missed_.fetch_add(1, std::memory_order_relaxed);
+            finish(stamp);
+        }
+    }
+
+    // ---------------- other threads ----------------
+
+    void reset(){
+        count_.store(0, std::memory_order_relaxed);
+        missed_.store(0, std::memory_order_relaxed);
+        sumNs_.store(0, std::memory_order_relaxed);
+        minNs_.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        maxNs_.store(0, std::memory_order_relaxed);
+        for ( auto& b : histogram_ ) b.store(0, std::memory_order_relaxed);
+    }
+
+    json describe() const {
+        uint64_t count = count_.load(std::memory_order_relaxed);
+        std::array<uint64_t, N_BUCKETS> counts ;
+        for ( size_t k = 0 ; k < N_BUCKETS ; ++k ) counts[k] = histogram_[k].load(std::memory_order_relaxed);
+
+        return {
+            {"enabled", isEnabled()},
+            {"count", count},
+            {"missed", missed_.load(std::memory_order_relaxed)},
+            {"minMs", count > 0 ? minNs_.load(std::memory_order_relaxed) * 1e-6 : 0.0},
+            {"meanMs", count > 0 ? sumNs_.load(std::memory_order_relaxed) * 1e-6 / count : 0.0},
+            {"maxMs", maxNs_.load(std::memory_order_relaxed) * 1e-6},
+            {"p50Ms", percentile(counts, count, 0.5)},
+            {"p99Ms", percentile(counts, count, 0.99)},
+            {"streamLatencyMs", streamLatencyMs_.load(std::memory_order_relaxed)},
+            {"bucketMs", 1.0},
+            {"histogram", counts}
+        };
+    }
+
+private:
+    void record(uint64_t ns){
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sumNs_.fetch_add(ns, std::memory_order_relaxed);
+        if ( ns < minNs_.load(std::memory_order_relaxed) ) minNs_.store(ns, std::memory_order_relaxed);
+        if ( ns > maxNs_.load(std::memory_order_relaxed) ) maxNs_.store(ns, std::memory_order_relaxed);
+        histogram_[std::min<size_t>(ns / 1000000, N_BUCKETS - 1)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void finish(uint64_t stamp){
+        pending_.compare_exchange_strong(stamp, 0, std::memory_order_relaxed);
+        heard_ = 0 ;
+    }
+
+    // upper edge of the bucket holding the q quantile
+    static double percentile(const std::array<uint64_t, N_BUCKETS>& counts, uint64_t total, double q){
+        if ( total == 0 ) return 0.0 ;
+        uint64_t target = static_cast<uint64_t>(std::ceil(q * total));
+        uint64_t seen = 0 ;
+        for ( size_t k = 0 ; k < N_BUCKETS ; ++k ){
+            seen += counts[k] ;
+            if ( seen >= target ) return static_cast<double>(k + 1);
+        }
+        return static_cast<double>(N_BUCKETS);
+    }
+};
+
+#endif // __LATENCY_PROBE_HPP_
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "diagnostics/Log.hpp"
+#include "config/Config.hpp"
+
+#include <chrono>
+#include <fmt/args.h>
+
+namespace {
+    const char* const subsystemNames[Log::N_SUBSYSTEMS] = {
+        "engine", "audio", "midi", "api"
+    };
+}
+
+std::array<std::atomic<spdlog::level::level_enum>, Log::N_SUBSYSTEMS> Log::levels_{{
+    {spdlog::level::info}, {spdlog::level::info}, {spdlog::level::info}, {spdlog::level::info}
+}} ;
+
+Log::Log():
+    logger_(spdlog::default_logger()->clone("log"))
+{
+    logger_->set_level(spdlog::level::trace);
+}
+
+Log::~Log(){
+    stop();
+}
+
+Log* Log::instance(){
+    static Log log ;
+    return &log ;
+}
+
+void Log::setLevel(LogSubsystem subsystem, spdlog::level::level_enum level){
+    levels_[static_cast<size_t>(subsystem)].store(level, std::memory_order_relaxed);
+    if ( subsystem == LogSubsystem::ENGINE ){
+        spdlog::set_level(level);
+    }
+}
+
+spdlog::level::level_enum Log::getLevel(LogSubsystem subsystem){
+    return levels_[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed);
+}
+
+const char* Log::subsystemName(LogSubsystem subsystem){
+    return subsystemNames[static_cast<size_t>(subsystem)] ;
+}
+
+std::optional<LogSubsystem> Log::subsystemFromString(const std::string& name){
+    for ( size_t i = 0 ; i < N_SUBSYSTEMS ; ++i ){
+        if ( name == subsystemNames[i] ) return static_cast<LogSubsystem>(i);
+    }
+    return std::nullopt ;
+}
+
+std::optional<spdlog::level::level_enum> Log::levelFromString(const std::string& name){
+    // spdlog maps anything it doesn't know to off
+    spdlog::level::level_enum level = spdlog::level::from_str(name);
+    if ( level == spdlog::level::off && name != "off" ) return std::nullopt ;
+    return level ;
+}
+
+void Log::configure(){
+    for ( size_t i = 0 ; i < N_SUBSYSTEMS ; ++i ){
+        auto name = Config::get<std::string>(std::string("logging.") + subsystemNames[i]);
+        if ( !name ) continue ;
+        if ( auto level = levelFromString(*name) ){
+            setLevel(static_cast<LogSubsystem>(i), *level);
+        } else {
+            SPDLOG_WARN("Unknown log level {} for {}, keeping {}.", *name, subsystemNames[i],
+                spdlog::level::to_string_view(getLevel(static_cast<LogSubsystem>(i))));
+        }
+    }
+}
+
+void Log::start(){
+    if ( running_ ) return ;
+    running_ = true ;
+    thread_ = std::thread([this](){ run(); });
+}
+
+void Log::stop(){
+    if ( !running_ ) return ;
+    running_ = false ;
+    if ( thread_.joinable() ) thread_.join();
+}
+
+json Log::status() const {
+    json levels = json::object();
+    for ( size_t i = 0 ; i < N_SUBSYSTEMS ; ++i ){
+        auto level = spdlog::level::to_string_view(getLevel(static_cast<LogSubsystem>(i)));
+        levels[subsystemNames[i]] = std::string(level.data(), level.size());
+    }
+    return {
+        {"levels", levels},
+        {"dropped", dropped_.load(std::memory_order_relaxed)}
+    };
+}
+
+void Log::run(){
+    uint64_t reported = 0 ;
+    while ( running_ ){
+        drain(reported);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    // records pushed while stopping
+    drain(reported);
+}
+
+void Log::drain(uint64_t& reported){
+    Record record ;
+    bool any = false ;
+    while ( queue_.pop(record) ){
+        write(record);
+        any = true ;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if ( dropped != reported ){
+        SPDLOG_LOGGER_WARN(logger_, "Log queue overflowed, dropped {} records.", dropped - reported);
+        reported = dropped ;
+        any = true ;
+    }
+
+    if ( any ) logger_->flush();
+}
+
+void Log::write(const Record& record){
+    fmt::dynamic_format_arg_store<fmt::format_context> args ;
+    for ( size_t i = 0 ; i < record.nArgs ; ++i ){
+        const Arg& arg = record.args[i] ;
+        switch ( arg.kind ){
+            case Arg::INT:    args.push_back(arg.i); break ;
+            case Arg::UINT:   args.push_back(arg.u); break ;
+            case Arg::FLOAT:  args.push_back(arg.f); break ;
+            case Arg::BOOL:   args.push_back(arg.b); break ;
+            case Arg::STRING: args.push_back(arg.s); break ;
+        }
+    }
+
+    std::string message ;
+    try {
+        message = fmt::vformat(record.format, args);
+    } catch ( const fmt::format_error& e ){
+        message = std::string(record.format) + " (bad log format: " + e.what() + ")" ;
+    }
+    logger_->log(record.time, spdlog::source_loc{record.file, record.line, record.function}, record.level, message);
+}
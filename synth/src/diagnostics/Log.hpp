@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LOG_HPP_
+#define __LOG_HPP_
+
+#include "containers/MPSCQueue.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+enum class LogSubsystem : uint8_t {
+    ENGINE, // everything without a subsystem of its own, follows spdlog's global level
+    AUDIO,
+    MIDI,
+    API,
+    N_SUBSYSTEMS
+};
+
+/**
+ * @brief logging with a level per subsystem, safe to use from the audio and midi threads
+ *
+ * LOG_RT copies the format string pointer and up to MAX_ARGS numbers, bools or string
+ * literals into a fixed size record and pushes it onto a lock-free queue. A background
+ * thread formats the records and hands them to spdlog with the time they were made, so
+ * the calling thread never formats, allocates or takes a lock. Records that find the
+ * queue full are dropped and counted.
+ *
+ * LOG_AT logs synchronously behind the same level check, for threads that may block but
+ * want their subsystem's level to apply, such as the api dumping whole requests.
+ */
+class Log {
+public:
+    static constexpr size_t MAX_ARGS = 6 ;
+    static constexpr size_t QUEUE_SIZE = 4096 ;
+    static constexpr size_t N_SUBSYSTEMS = static_cast<size_t>(LogSubsystem::N_SUBSYSTEMS) ;
+
+    struct Arg {
+        enum Kind : uint8_t { INT, UINT, FLOAT, BOOL, STRING } kind ;
+        union {
+            int64_t i ;
+            uint64_t u ;
+            double f ;
+            bool b ;
+            const char* s ;
+        };
+    };
+
+private:
+    struct Record {
+        spdlog::log_clock::time_point time ;
+        const char* format ;
+        const char* file ;
+        const char* function ;
+        int line ;
+        spdlog::level::level_enum level ;
+        uint8_t nArgs ;
+        std::array<Arg, MAX_ARGS> args ;
+    };
+
+    static std::array<std::atomic<spdlog::level::level_enum>, N_SUBSYSTEMS> levels_ ;
+
+    MPSCQueue<Record> queue_{QUEUE_SIZE} ;
+    std::atomic<uint64_t> dropped_{0} ;
+    std::shared_ptr<spdlog::logger> logger_ ; // shares the default logger's sinks, lets every level through
+
+    std::thread thread_ ;
+    std::atomic<bool> running_{false} ;
+
+    Log();
+
+public:
+    ~Log();
+    Log(const Log&) = delete ;
+    Log& operator=(const Log&) = delete ;
+
+    static Log* instance();
+
+    static bool enabled(LogSubsystem subsystem, spdlog::level::level_enum level){
+        return level >= levels_[static_cast<size_t>(subsystem)].load(std::memory_order_relaxed);
+    }
+
+    static void setLevel(LogSubsystem subsystem, spdlog::level::level_enum level);
+    static spdlog::level::level_enum getLevel(LogSubsystem subsystem);
+
+    static const char* subsystemName(LogSubsystem subsystem);
+    static std::optional<LogSubsystem> subsystemFromString(const std::string& name);
+    static std::optional<spdlog::level::level_enum> levelFromString(const std::string& name);
+
+    // apply the levels under "logging" in the config
+    void configure();
+
+    // start and stop the thread writing queued records, stopping writes what is left
+    void start();
+    void stop();
+
+    json status() const ;
+
+    spdlog::logger* logger(){
+        return logger_.get() ;
+    }
+
+    template <typename... Args>
+    void push(spdlog::level::level_enum level, const char* file, int line, const char* function, const char* format, Args... args){
+        static_assert(sizeof...(Args) <= MAX_ARGS, "Log: too many arguments for a realtime log record");
+        Record record ;
+        record.time = spdlog::log_clock::now() ;
+        record.format = format ;
+        record.file = file ;
+        record.function = function ;
+        record.line = line ;
+        record.level = level ;
+        record.nArgs = sizeof...(Args) ;
+        size_t i = 0 ;
+        ((record.args[i++] = makeArg(args)), ...);
+
+        if ( !queue_.push(record) ){
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    template <typename T>
+    static Arg makeArg(T value){
+        Arg arg ;
+        if constexpr ( std::is_same_v<T, bool> ){
+            arg.kind = Arg::BOOL ;
+            arg.b = value ;
+        } else if constexpr ( std::is_enum_v<T> ){
+            arg.kind = Arg::INT ;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr ( std::is_integral_v<T> && std::is_signed_v<T> ){
+            arg.kind = Arg::INT ;
+            arg.i = value ;
+        } else if constexpr ( std::is_integral_v<T> ){
+            arg.kind = Arg::UINT ;
+            arg.u = value ;
+        } else if constexpr ( std::is_floating_point_v<T> ){
+            arg.kind = Arg::FLOAT ;
+            arg.f = value ;
+        } else {
+            static_assert(std::is_convertible_v<T, const char*>, "Log: realtime arguments must be numbers, bools or string literals");
+            arg.kind = Arg::STRING ;
+            arg.s = value ;
+        }
+        return arg ;
+    }
+
+    void run();
+    void drain(uint64_t& reported); // reported counts the drops already warned about
+    void write(const Record& record);
+};
+
+#define LOG_RT(subsystem, level, ...) do { \
+    if ( Log::enabled(subsystem, level) ) Log::instance()->push(level, __FILE__, __LINE__, SPDLOG_FUNCTION, __VA_ARGS__); \
+} while(0)
+
+#define LOG_AT(subsystem, level, ...) do { \
+    if ( Log::enabled(subsystem, level) ) Log::instance()->logger()->log(spdlog::source_loc{__FILE__, __LINE__, SPDLOG_FUNCTION}, level, __VA_ARGS__); \
+} while(0)
+
+#endif // __LOG_HPP_
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "diagnostics/RtCheck.hpp"
+
+#ifdef SYNTH_RT_CHECK
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+// glibc's allocator entry points, the replacements below forward to these
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t n, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void  __libc_free(void* ptr);
+}
+
+namespace {
+    // constant initialized, so usable before static constructors have run
+    thread_local int realtimeDepth = 0 ;
+    thread_local int allowDepth = 0 ;
+    thread_local bool reporting = false ;
+
+    std::atomic<uint64_t> counts[RtCheck::N_VIOLATIONS] ;
+    std::atomic<bool> reported[RtCheck::N_VIOLATIONS] ;
+
+    const char* const violationNames[RtCheck::N_VIOLATIONS] = {
+        "allocation", "deallocation", "lock", "syscall"
+    };
+
+    using WriteFn = ssize_t(*)(int, const void*, size_t);
+    WriteFn realWrite();
+
+    // stderr without going through anything that allocates or locks
+    void report(const char* text){
+        realWrite()(STDERR_FILENO, text, std::strlen(text));
+    }
+
+    void violation(RtCheck::Violation kind, const char* call){
+        if ( realtimeDepth == 0 || allowDepth > 0 || reporting ) return ;
+        reporting = true ;
+
+        counts[kind].fetch_add(1, std::memory_order_relaxed);
+        if ( !reported[kind].exchange(true) ){
+            report("realtime violation (");
+            report(violationNames[kind]);
+            report(") on the audio thread: ");
+            report(call);
+            report("\n");
+            void* frames[64] ;
+            int depth = backtrace(frames, 64);
+            backtrace_symbols_fd(frames, depth, STDERR_FILENO);
+        }
+
+        static const bool abortOnViolation = std::getenv("SYNTH_RT_CHECK_ABORT") != nullptr ;
+        if ( abortOnViolation ) std::abort();
+        reporting = false ;
+    }
+
+    template <typename Fn>
+    Fn next(const char* symbol){
+        return reinterpret_cast<Fn>(dlsym(RTLD_NEXT, symbol));
+    }
+
+    WriteFn realWrite(){
+        static WriteFn fn = next<WriteFn>("write");
+        return fn ;
+    }
+}
+
+void RtCheck::enter(){ ++realtimeDepth ; }
+void RtCheck::leave(){ --realtimeDepth ; }
+void RtCheck::allow(){ ++allowDepth ; }
+void RtCheck::disallow(){ --allowDepth ; }
+
+uint64_t RtCheck::getCount(Violation v){
+    return counts[v].load(std::memory_order_relaxed);
+}
+
+// ---------------- allocation ----------------
+
+extern "C" {
+    void* malloc(size_t size) noexcept {
+        violation(RtCheck::ALLOCATION, "malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t n, size_t size) noexcept {
+        violation(RtCheck::ALLOCATION, "calloc");
+        return __libc_calloc(n, size);
+    }
+
+    void* realloc(void* ptr, size_t size) noexcept {
+        violation(RtCheck::ALLOCATION, "realloc");
+        return __libc_realloc(ptr, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size) noexcept {
+        violation(RtCheck::ALLOCATION, "aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** ptr, size_t alignment, size_t size) noexcept {
+        violation(RtCheck::ALLOCATION, "posix_memalign");
+        *ptr = __libc_memalign(alignment, size);
+        return *ptr ? 0 : ENOMEM ;
+    }
+
+    void free(void* ptr) noexcept {
+        if ( ptr ) violation(RtCheck::DEALLOCATION, "free");
+        __libc_free(ptr);
+    }
+}
+
+namespace {
+    void* allocate(size_t size, const char* call){
+        violation(RtCheck::ALLOCATION, call);
+        void* ptr = __libc_malloc(size ? size : 1);
+        if ( !ptr ) throw std::bad_alloc();
+        return ptr ;
+    }
+
+    void* allocateAligned(size_t size, std::align_val_t alignment, const char* call){
+        violation(RtCheck::ALLOCATION, call);
+        void* ptr = __libc_memalign(static_cast<size_t>(alignment), size ? size : 1);
+        if ( !ptr ) throw std::bad_alloc();
+        return ptr ;
+    }
+
+    void deallocate(void* ptr, const char* call){
+        if ( ptr ) violation(RtCheck::DEALLOCATION, call);
+        __libc_free(ptr);
+    }
+}
+
+void* operator new(size_t size){ return allocate(size, "operator new"); }
+void* operator new[](size_t size){ return allocate(size, "operator new[]"); }
+void* operator new(size_t size, std::align_val_t a){ return allocateAligned(size, a, "operator new"); }
+void* operator new[](size_t size, std::align_val_t a){ return allocateAligned(size, a, "operator new[]"); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    violation(RtCheck::ALLOCATION, "operator new");
+    return __libc_malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    violation(RtCheck::ALLOCATION, "operator new[]");
+    return __libc_malloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { deallocate(ptr, "operator delete"); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr, "operator delete[]"); }
+void operator delete(void* ptr, size_t) noexcept { deallocate(ptr, "operator delete"); }
+void operator delete[](void* ptr, size_t) noexcept { deallocate(ptr, "operator delete[]"); }
+void operator delete(void* ptr, std::align_val_t) noexcept { deallocate(ptr, "operator delete"); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { deallocate(ptr, "operator delete[]"); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { deallocate(ptr, "operator delete"); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { deallocate(ptr, "operator delete[]"); }
+
+// ---------------- locks and syscalls ----------------
+
+extern "C" {
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+        static auto real = next<int(*)(pthread_mutex_t*)>("pthread_mutex_lock");
+        violation(RtCheck::LOCK, "pthread_mutex_lock");
+        return real(mutex);
+    }
+
+    ssize_t write(int fd, const void* buf, size_t count){
+        violation(RtCheck::SYSCALL, "write");
+        return realWrite()(fd, buf, count);
+    }
+
+    ssize_t read(int fd, void* buf, size_t count){
+        static auto real = next<ssize_t(*)(int, void*, size_t)>("read");
+        violation(RtCheck::SYSCALL, "read");
+        return real(fd, buf, count);
+    }
+
+    int nanosleep(const struct timespec* req, struct timespec* rem){
+        static auto real = next<int(*)(const struct timespec*, struct timespec*)>("nanosleep");
+        violation(RtCheck::SYSCALL, "nanosleep");
+        return real(req, rem);
+    }
+
+    int usleep(useconds_t usec){
+        static auto real = next<int(*)(useconds_t)>("usleep");
+        violation(RtCheck::SYSCALL, "usleep");
+        return real(usec);
+    }
+}
+
+#endif // SYNTH_RT_CHECK
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RT_CHECK_HPP_
+#define __RT_CHECK_HPP_
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+/**
+ * @brief flags calls that are not realtime safe when made from a marked thread
+ *
+ * Only active in builds configured with SYNTH_RT_CHECK. Those builds replace operator
+ * new/delete, malloc and friends, pthread_mutex_lock and a few blocking syscalls with
+ * versions that count a violation whenever the calling thread is inside a Scope. The
+ * first violation of each kind prints a backtrace to stderr, and with the environment
+ * variable SYNTH_RT_CHECK_ABORT set the process aborts right there.
+ *
+ * In other builds every call here compiles to nothing.
+ */
+class RtCheck {
+public:
+    enum Violation : uint8_t {
+        ALLOCATION,
+        DEALLOCATION,
+        LOCK,
+        SYSCALL,
+        N_VIOLATIONS
+    };
+
+#ifdef SYNTH_RT_CHECK
+    static constexpr bool ENABLED = true ;
+
+    static void enter();
+    static void leave();
+    static void allow();
+    static void disallow();
+    static uint64_t getCount(Violation v);
+#else
+    static constexpr bool ENABLED = false ;
+
+    static void enter(){}
+    static void leave(){}
+    static void allow(){}
+    static void disallow(){}
+    static uint64_t getCount(Violation){ return 0 ; }
+#endif
+
+    static uint64_t getTotal(){
+        uint64_t total = 0 ;
+        for ( int v = 0 ; v < N_VIOLATIONS ; ++v ) total += getCount(static_cast<Violation>(v));
+        return total ;
+    }
+
+    static json report(){
+        return {
+            {"enabled", ENABLED},
+            {"allocations", getCount(ALLOCATION)},
+            {"deallocations", getCount(DEALLOCATION)},
+            {"locks", getCount(LOCK)},
+            {"syscalls", getCount(SYSCALL)}
+        };
+    }
+
+    // the calling thread is realtime until the scope ends
+    class Scope {
+    public:
+        Scope(){ enter(); }
+        ~Scope(){ leave(); }
+        Scope(const Scope&) = delete ;
+        Scope& operator=(const Scope&) = delete ;
+    };
+
+    // suspends checking, for diagnostics that knowingly allocate once
+    class Allow {
+    public:
+        Allow(){ allow(); }
+        ~Allow(){ disallow(); }
+        Allow(const Allow&) = delete ;
+        Allow& operator=(const Allow&) = delete ;
+    };
+};
+
+#endif // __RT_CHECK_HPP_
@@ -0,0 +1,249 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "diagnostics/Tracer.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+std::atomic<bool> Tracer::enabled_{false} ;
+thread_local Tracer::ThreadBuffer* Tracer::local_ = nullptr ;
+thread_local const char* Tracer::threadName_ = nullptr ;
+thread_local Tracer::Lease Tracer::lease_ ;
+
+Tracer* Tracer::instance(){
+    static Tracer tracer ;
+    return &tracer ;
+}
+
+Tracer::~Tracer(){
+    // the engine writes an unfinished trace at shutdown, here only the thread is left
+    if ( flushThread_.joinable() ){
+        flushing_ = false ;
+        flushThread_.join();
+    }
+}
+
+void Tracer::setThreadName(const char* name){
+    threadName_ = name ;
+    if ( !local_ ) local_ = instance()->claimReserved(name);
+    if ( local_ ) local_->name.store(name, std::memory_order_relaxed);
+}
+
+void Tracer::reserveThread(const char* name){
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    for ( auto& slot : reserved_ ){
+        ThreadBuffer* buffer = slot.load(std::memory_order_relaxed);
+        if ( buffer && std::strcmp(buffer->reservation, name) == 0 ){
+            // a restarted stream or port runs on a new thread, which takes the ring over
+            buffer->owned.store(false, std::memory_order_release);
+            return ;
+        }
+        if ( !buffer ){
+            auto reserved = std::make_unique<ThreadBuffer>();
+            reserved->tid = ++nextTid_ ;
+            reserved->reservation = name ;
+            reserved->name.store(name, std::memory_order_relaxed);
+            slot.store(reserved.get(), std::memory_order_release);
+            buffers_.push_back(std::move(reserved));
+            return ;
+        }
+    }
+    SPDLOG_WARN("No trace ring left to reserve for thread {}", name);
+}
+
+// lock and allocation free, called from the threads' callbacks
+Tracer::ThreadBuffer* Tracer::claimReserved(const char* name){
+    for ( auto& slot : reserved_ ){
+        ThreadBuffer* buffer = slot.load(std::memory_order_acquire);
+        if ( !buffer ) break ;
+        bool free = false ;
+        if ( std::strcmp(buffer->reservation, name) == 0 &&
+            buffer->owned.compare_exchange_strong(free, true, std::memory_order_acquire) ){
+            return buffer ;
+        }
+    }
+    return nullptr ;
+}
+
+Tracer::ThreadBuffer* Tracer::registerThread(){
+    // once per thread and only while tracing
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    ThreadBuffer* buffer = nullptr ;
+    for ( auto& b : buffers_ ){
+        bool free = false ;
+        if ( !b->reservation && b->owned.compare_exchange_strong(free, true, std::memory_order_acquire) ){
+            buffer = b.get() ;
+            break ;
+        }
+    }
+
+    if ( buffer ){
+        // collect what the exited thread left behind before its ring changes hands
+        drain(*buffer);
+        retired_.push_back({buffer->tid, buffer->name.load(std::memory_order_relaxed)});
+    } else {
+        auto fresh = std::make_unique<ThreadBuffer>();
+        fresh->owned.store(true, std::memory_order_relaxed);
+        buffer = fresh.get() ;
+        buffers_.push_back(std::move(fresh));
+    }
+    buffer->tid = ++nextTid_ ;
+    buffer->name.store(threadName_, std::memory_order_relaxed);
+    lease_.buffer = buffer ;
+    local_ = buffer ;
+    return local_ ;
+}
+
+void Tracer::setDirectory(const std::string& directory){
+    std::lock_guard<std::mutex> control(controlMutex_);
+    directory_ = std::filesystem::absolute(directory.empty() ? "." : directory);
+}
+
+bool Tracer::isFileName(const std::string& name){
+    return !name.empty() && name.find('/') == std::string::npos && name.find("..") == std::string::npos ;
+}
+
+bool Tracer::start(const std::string& name){
+    if ( !isFileName(name) ) return false ;
+    std::lock_guard<std::mutex> control(controlMutex_);
+    if ( flushing_ ) stopLocked();
+
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex_);
+        // throw away anything recorded after the last trace was drained
+        TraceEvent discard[256] ;
+        for ( auto& buffer : buffers_ ){
+            while ( buffer->ring.pop(discard, 256) > 0 );
+            buffer->dropped.store(0, std::memory_order_relaxed);
+        }
+        records_.clear();
+        retired_.clear();
+        lost_ = 0 ;
+        origin_ = now();
+        path_ = ( directory_ / name ).string() ;
+    }
+
+    flushing_ = true ;
+    flushThread_ = std::thread([this](){ flushLoop(); });
+    enabled_.store(true, std::memory_order_relaxed);
+    SPDLOG_INFO("Tracing started, writing to {} when stopped.", path_);
+    return true ;
+}
+
+bool Tracer::stop(){
+    std::lock_guard<std::mutex> control(controlMutex_);
+    return stopLocked();
+}
+
+// controlMutex_ held
+bool Tracer::stopLocked(){
+    if ( !flushing_ ) return false ;
+    enabled_.store(false, std::memory_order_relaxed);
+    flushing_ = false ;
+    if ( flushThread_.joinable() ) flushThread_.join();
+    drain();
+    return write();
+}
+
+json Tracer::status(){
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    uint64_t dropped = lost_ ;
+    for ( const auto& buffer : buffers_ ) dropped += buffer->dropped.load(std::memory_order_relaxed);
+    return {
+        {"enabled", enabled()},
+        {"path", path_},
+        {"events", records_.size()},
+        {"dropped", dropped},
+        {"threads", buffers_.size()}
+    };
+}
+
+void Tracer::flushLoop(){
+    setThreadName("trace flush");
+    while ( flushing_ ){
+        drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+}
+
+void Tracer::drain(){
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    for ( auto& buffer : buffers_ ) drain(*buffer);
+}
+
+// buffersMutex_ held
+void Tracer::drain(ThreadBuffer& buffer){
+    TraceEvent events[256] ;
+    size_t n ;
+    while ( ( n = buffer.ring.pop(events, 256) ) > 0 ){
+        for ( size_t i = 0 ; i < n ; ++i ){
+            if ( records_.size() >= MAX_EVENTS ){
+                ++lost_ ;
+                continue ;
+            }
+            records_.push_back({buffer.tid, events[i]});
+        }
+    }
+}
+
+bool Tracer::write(){
+    std::lock_guard<std::mutex> lock(buffersMutex_);
+    std::ofstream file(path_);
+    if ( !file ){
+        SPDLOG_ERROR("Could not open trace file {}", path_);
+        return false ;
+    }
+
+    // events are streamed out one by one, a long trace would not fit a single json value
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" ;
+    bool first = true ;
+    auto emit = [&file, &first](const json& event){
+        if ( !first ) file << ",\n" ;
+        file << event.dump();
+        first = false ;
+    };
+
+    emit({{"name", "process_name"}, {"ph", "M"}, {"pid", 1}, {"args", {{"name", "synth"}}}});
+    auto emitThread = [&emit](uint32_t tid, const char* name){
+        emit({
+            {"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", tid},
+            {"args", {{"name", name ? name : "thread " + std::to_string(tid)}}}
+        });
+    };
+    for ( const auto& buffer : buffers_ ) emitThread(buffer->tid, buffer->name.load(std::memory_order_relaxed));
+    for ( const auto& [tid, name] : retired_ ) emitThread(tid, name);
+
+    for ( const Record& r : records_ ){
+        if ( r.event.time < origin_ ) continue ;
+        json event = {
+            {"name", r.event.name},
+            {"ph", std::string(1, static_cast<char>(r.event.phase))},
+            {"ts", ( r.event.time - origin_ ) * 1e-3},
+            {"pid", 1},
+            {"tid", r.tid}
+        };
+        if ( r.event.phase == TracePhase::COUNTER ) event["args"] = {{"value", r.event.value}};
+        if ( r.event.phase == TracePhase::INSTANT ) event["s"] = "t" ;
+        emit(event);
+    }
+    file << "\n]}\n" ;
+
+    SPDLOG_INFO("Wrote {} trace events to {}", records_.size(), path_);
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TRACER_HPP_
+#define __TRACER_HPP_
+
+#include "containers/LockFreeRingBuffer.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
+enum class TracePhase : char {
+    BEGIN = 'B',
+    END = 'E',
+    COUNTER = 'C',
+    INSTANT = 'i'
+};
+
+/**
+ * @brief one timeline event. Names must be string literals, only the pointer is kept
+ */
+struct TraceEvent {
+    uint64_t time ; // steady_clock ns
+    const char* name ;
+    double value ;  // counters only
+    TracePhase phase ;
+};
+
+/**
+ * @brief timeline of engine thread activity, written as Chrome trace json
+ *
+ * Every thread that records an event gets its own single producer ring, so recording
+ * is a clock read and a ring push. A background thread drains the rings while tracing
+ * runs and the file is written on stop. The json opens in chrome://tracing and in the
+ * Perfetto UI.
+ *
+ * Realtime threads get their ring reserved up front and claim it by name, so they never
+ * lock or allocate. Any other thread registers the first time it records while tracing
+ * is enabled, taking over the ring of an exited thread if there is one. Events that don't
+ * fit in a full ring are dropped and counted.
+ */
+class Tracer {
+public:
+    static constexpr size_t THREAD_BUFFER_SIZE = 1 << 15 ;
+    static constexpr size_t MAX_EVENTS = 1 << 22 ; // kept in memory until the file is written
+    static constexpr size_t MAX_RESERVED = 8 ;
+
+private:
+    struct ThreadBuffer {
+        LockFreeRingBuffer<TraceEvent> ring{THREAD_BUFFER_SIZE} ;
+        uint32_t tid ;
+        const char* reservation = nullptr ; // held for the thread of that name
+        std::atomic<const char*> name{nullptr} ;
+        std::atomic<uint64_t> dropped{0} ;
+        std::atomic<bool> owned{false} ; // a live thread records into it
+    };
+
+    // hands a registered thread's ring back when the thread exits
+    struct Lease {
+        ThreadBuffer* buffer = nullptr ;
+        ~Lease(){
+            if ( buffer ) buffer->owned.store(false, std::memory_order_release);
+        }
+    };
+
+    struct Record {
+        uint32_t tid ;
+        TraceEvent event ;
+    };
+
+    static std::atomic<bool> enabled_ ;
+    static thread_local ThreadBuffer* local_ ;
+    static thread_local const char* threadName_ ;
+    static thread_local Lease lease_ ;
+
+    std::mutex controlMutex_ ; // serializes start and stop, which API workers may call at once
+    std::mutex buffersMutex_ ; // registration, draining and start/stop
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_ ;
+    std::array<std::atomic<ThreadBuffer*>, MAX_RESERVED> reserved_{} ; // claimed without locking
+    std::vector<std::pair<uint32_t, const char*>> retired_ ; // threads whose ring went to another
+    uint32_t nextTid_ = 0 ;
+    std::vector<Record> records_ ;
+    uint64_t lost_ = 0 ; // over MAX_EVENTS
+    uint64_t origin_ = 0 ;
+    std::string path_ ;
+    std::filesystem::path directory_ = std::filesystem::current_path() ;
+
+    std::thread flushThread_ ;
+    std::atomic<bool> flushing_{false} ;
+
+    Tracer() = default ;
+
+public:
+    ~Tracer();
+    Tracer(const Tracer&) = delete ;
+    Tracer& operator=(const Tracer&) = delete ;
+
+    static Tracer* instance();
+
+    static bool enabled(){
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    static uint64_t now(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    // names the calling thread in the trace, name must be a string literal. Claims a ring reserved under that name
+    static void setThreadName(const char* name);
+
+    // keep a ring for the thread that will call setThreadName(name). Outside the thread, before it starts
+    void reserveThread(const char* name);
+
+    static void begin(const char* name){ record(name, TracePhase::BEGIN, 0.0); }
+    static void end(const char* name){ record(name, TracePhase::END, 0.0); }
+    static void instant(const char* name){ record(name, TracePhase::INSTANT, 0.0); }
+    static void counter(const char* name, double value){ record(name, TracePhase::COUNTER, value); }
+
+    // where traces are written, fixed at startup so API clients can only pick a file name
+    void setDirectory(const std::string& directory);
+
+    // a plain file name, no directories and nothing that could climb out of the trace directory
+    static bool isFileName(const std::string& name);
+
+    // start collecting events, the trace is written to the named file in the trace directory when stopped
+    bool start(const std::string& name);
+
+    // stop collecting and write the trace file
+    bool stop();
+
+    json status();
+
+private:
+    static void record(const char* name, TracePhase phase, double value){
+        if ( !enabled() ) return ;
+        ThreadBuffer* buffer = local_ ? local_ : instance()->registerThread() ;
+        TraceEvent event{now(), name, value, phase} ;
+        if ( !buffer->ring.push(&event, 1) ){
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    ThreadBuffer* registerThread();
+    ThreadBuffer* claimReserved(const char* name);
+    bool stopLocked();
+    void flushLoop();
+    void drain();
+    void drain(ThreadBuffer& buffer);
+    bool write();
+};
+
+/**
+ * @brief begin/end pair around a scope, skipped entirely while tracing is off
+ */
+class TraceScope {
+private:
+    const char* name_ ;
+    bool active_ ;
+
+public:
+    TraceScope(const char* name):
+        name_(name),
+        active_(Tracer::enabled())
+    {
+        if ( active_ ) Tracer::begin(name_);
+    }
+
+    ~TraceScope(){
+        if ( active_ ) Tracer::end(name_);
+    }
+
+    TraceScope(const TraceScope&) = delete ;
+    TraceScope& operator=(const TraceScope&) = delete ;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_COUNTER(name, value) do { if ( Tracer::enabled() ) Tracer::counter(name, value); } while(0)
+#define TRACE_INSTANT(name) do { if ( Tracer::enabled() ) Tracer::instant(name); } while(0)
+
+#endif // __TRACER_HPP_
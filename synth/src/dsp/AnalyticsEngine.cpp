@@ -17,6 +17,7 @@
 
 #include "dsp/AnalyticsEngine.hpp"
 #include "config/Config.hpp"
+#include "diagnostics/Tracer.hpp"
 #include <cmath>
 #include <cstring>
 #include "kissfft/kiss_fft.h"
@@ -145,6 +146,7 @@ void AnalyticsEngine::applyHannWindow(std::vector<double>& data) {
 
 void AnalyticsEngine::processFFT() {
     if ( !fftConfig_ ) return ;
+    TRACE_SCOPE("fft");
 
     std::vector<double> windowedData = fftBuffer_ ; // makes a copy
     applyHannWindow(windowedData);
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "Resampler.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace {
+    // zeroth order modified bessel function of the first kind, for the kaiser window
+    double besselI0(double x){
+        double sum = 1.0 ;
+        double term = 1.0 ;
+        for ( int k = 1 ; k < 32 ; ++k ){
+            term *= ( x / ( 2.0 * k ) ) * ( x / ( 2.0 * k ) );
+            sum += term ;
+            if ( term < sum * 1e-12 ) break ;
+        }
+        return sum ;
+    }
+
+    constexpr double KAISER_BETA = 8.6 ; // roughly 87 dB of stopband rejection
+    constexpr double ATTENUATION = KAISER_BETA / 0.1102 + 8.7 ; // that rejection in dB
+}
+
+Resampler::Resampler(double inRate, double outRate, size_t taps):
+    taps_(std::max<size_t>(taps, 4))
+{
+    long long in = std::llround(inRate);
+    long long out = std::llround(outRate);
+    long long g = std::gcd(in, out);
+    up_ = out / g ;
+    down_ = in / g ;
+
+    // awkward ratios would need huge tables, approximate them with a bounded phase count
+    if ( up_ > MAX_PHASES ){
+        down_ = std::max<size_t>(1, std::llround(static_cast<double>(down_) * MAX_PHASES / up_));
+        up_ = MAX_PHASES ;
+        SPDLOG_WARN("Resampling {} -> {} Hz approximated with ratio {}/{}", inRate, outRate, up_, down_);
+    }
+
+    coeffs_.resize(up_ * taps_);
+    history_.assign(2 * taps_, 0.0);
+    design();
+}
+
+void Resampler::design(){
+    // prototype lowpass at the upsampled rate. The cutoff is the sinc's -6 dB point, it sits
+    // half of kaiser's transition width below the lower nyquist so the stopband starts there
+    // and nothing above it folds back. Fewer taps widen the transition and pull the cutoff down
+    const size_t length = up_ * taps_ ;
+    const double nyquist = 0.5 / std::max(up_, down_) ;
+    const double transition = ( ATTENUATION - 7.95 ) / ( 2.285 * 2.0 * M_PI * ( length - 1 ) ) ;
+    const double cutoff = std::max(0.5 * nyquist, nyquist - 0.5 * transition) ;
+    const double center = 0.5 * ( length - 1 ) ;
+    const double norm = besselI0(KAISER_BETA);
+
+    std::vector<double> h(length);
+    for ( size_t k = 0 ; k < length ; ++k ){
+        double t = k - center ;
+        double x = 2.0 * cutoff * t ;
+        double sinc = t == 0.0 ? 1.0 : std::sin(M_PI * x) / ( M_PI * x );
+        double r = t / center ;
+        double window = besselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm ;
+        h[k] = 2.0 * cutoff * sinc * window ;
+    }
+
+    // split into phases, each normalized to unity gain at DC
+    for ( size_t p = 0 ; p < up_ ; ++p ){
+        double* c = &coeffs_[p * taps_] ;
+        double sum = 0.0 ;
+        for ( size_t j = 0 ; j < taps_ ; ++j ){
+            c[taps_ - 1 - j] = h[p + j * up_] ;
+            sum += h[p + j * up_] ;
+        }
+        if ( sum != 0.0 ){
+            for ( size_t j = 0 ; j < taps_ ; ++j ) c[j] /= sum ;
+        }
+    }
+}
+
+size_t Resampler::inputFramesFor(size_t nOut) const {
+    if ( nOut == 0 ) return 0 ;
+    return pending_ + ( phase_ + ( nOut - 1 ) * down_ ) / up_ ;
+}
+
+size_t Resampler::maxInputFramesFor(size_t nOut) const {
+    if ( nOut == 0 ) return 0 ;
+    return ( down_ + up_ - 1 ) / up_ + ( up_ - 1 + ( nOut - 1 ) * down_ ) / up_ ;
+}
+
+void Resampler::process(const double* in, double* out, size_t nOut){
+    for ( size_t n = 0 ; n < nOut ; ++n ){
+        for ( ; pending_ > 0 ; --pending_ ) push(*in++);
+
+        const double* x = &history_[writePos_] ;
+        const double* c = &coeffs_[phase_ * taps_] ;
+        double acc = 0.0 ;
+        for ( size_t j = 0 ; j < taps_ ; ++j ) acc += c[j] * x[j] ;
+        out[n] = acc ;
+
+        phase_ += down_ ;
+        pending_ = phase_ / up_ ;
+        phase_ %= up_ ;
+    }
+}
+
+void Resampler::reset(){
+    std::fill(history_.begin(), history_.end(), 0.0);
+    writePos_ = 0 ;
+    phase_ = 0 ;
+    pending_ = 0 ;
+}
+
+double Resampler::getRatio() const {
+    return static_cast<double>(up_) / down_ ;
+}
+
+double Resampler::getLatency() const {
+    return 0.5 * ( taps_ - 1 ) * getRatio() ;
+}
+
+void Resampler::push(double x){
+    history_[writePos_] = x ;
+    history_[writePos_ + taps_] = x ;
+    if ( ++writePos_ == taps_ ) writePos_ = 0 ;
+}
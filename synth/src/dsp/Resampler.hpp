@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RESAMPLER_HPP_
+#define __RESAMPLER_HPP_
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief streaming polyphase resampler for a fixed rational rate ratio
+ *
+ * Output frames are pulled: ask inputFramesFor() how much input the next nOut frames
+ * consume, render that much, then process(). Filters are built in the constructor, so
+ * nothing allocates once the stream runs.
+ */
+class Resampler {
+public:
+    static constexpr size_t MAX_PHASES = 1024 ;
+
+private:
+    size_t up_ ;   // L, interpolation factor
+    size_t down_ ; // M, decimation factor
+    size_t taps_ ; // filter taps per phase
+
+    std::vector<double> coeffs_ ; // phase-major, oldest input first
+    std::vector<double> history_ ; // the last taps_ inputs, stored twice so any window is contiguous
+    size_t writePos_ = 0 ;
+    size_t phase_ = 0 ;
+    size_t pending_ = 0 ; // inputs to take before the next output
+
+public:
+    /**
+     * @param taps filter length per phase, trading CPU for a narrower transition band and so
+     * a flat passband reaching closer to nyquist
+     */
+    Resampler(double inRate, double outRate, size_t taps = 64);
+
+    /**
+     * @brief input frames the next nOut output frames consume
+     */
+    size_t inputFramesFor(size_t nOut) const ;
+
+    /**
+     * @brief the most input any nOut output frames can consume, for sizing render buffers
+     */
+    size_t maxInputFramesFor(size_t nOut) const ;
+
+    /**
+     * @brief produce nOut frames. in must hold exactly inputFramesFor(nOut) frames
+     */
+    void process(const double* in, double* out, size_t nOut);
+
+    void reset();
+
+    double getRatio() const ;
+
+    // output frames of delay added by the filter
+    double getLatency() const ;
+
+private:
+    void push(double x);
+    void design();
+};
+
+#endif // __RESAMPLER_HPP_
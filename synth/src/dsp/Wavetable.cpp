@@ -22,6 +22,7 @@
 #include <mutex>
 #include <random>
 #include <cstddef>
+#include <sys/mman.h>
 
 // define static members
 std::once_flag Wavetable::initFlag_ ;
@@ -49,6 +50,14 @@ void Wavetable::generate(){
     });
 }
 
+bool Wavetable::lock(){
+    bool ok = true ;
+    for ( const auto& v : waves_ ){
+        if ( !v.empty() && mlock(v.data(), v.size() * sizeof(double)) != 0 ) ok = false ;
+    }
+    return ok ;
+}
+
 void Wavetable::generateSineWavetable(){\
     std::vector<double>& w = waves_[static_cast<int>(Waveform::SINE)];
     double phase ;
@@ -47,6 +47,13 @@ public:
     */
     static const Wave getWavetable(Waveform waveform);
 
+    /**
+     * @brief keep the generated tables resident in memory
+     * 
+     * @return false if any table could not be locked
+    */
+    static bool lock();
+
 private:
     static void generateSineWavetable();
     static void generateSquareWavetable();
@@ -18,10 +18,21 @@
 #ifndef __DSP_MATH_HPP_
 #define __DSP_MATH_HPP_
 
+#include <bit>
+#include <cstdint>
+
 namespace dsp {
     inline double fastAtan(double inp){
         return inp / (1.0 + 0.28 * inp * inp);
     }
+
+    // std::isfinite can't be used for this, -ffast-math lets the compiler assume every
+    // double is finite and drop the check. NaN and Inf are the only values with all
+    // exponent bits set
+    inline bool isFinite(double value){
+        constexpr uint64_t EXPONENT = 0x7FF0000000000000 ;
+        return (std::bit_cast<uint64_t>(value) & EXPONENT) != EXPONENT ;
+    }
 }
 
 #endif // __DSP_MATH_HPP_
\ No newline at end of file
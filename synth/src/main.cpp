@@ -17,18 +17,107 @@
 
 #include "core/Engine.hpp"
 #include "config/Config.hpp"
+#include "diagnostics/Log.hpp"
+#include "render/RenderOptions.hpp"
 
 #include <rtaudio/RtAudio.h>
 #include <rtmidi/RtMidi.h>
 #include <spdlog/spdlog.h>
+#include <cstdio>
+#include <string>
+
+namespace {
+    void printUsage(const char* program){
+        std::printf(
+            "usage: %s [--render patch.json --out out.wav [--midi in.mid] [--seconds N]]\n"
+            "       %s --latency-test N [--patch patch.json]\n"
+            "  without --render the engine starts its api server and waits for a client\n"
+            "  --latency-test plays N notes into a null audio device and prints the latency stats\n",
+            program,
+            program
+        );
+    }
+
+    /**
+     * @brief parse the offline render flags
+     * 
+     * @return false on unknown or incomplete arguments
+     */
+    bool parseRenderArgs(int argc, char** argv, RenderOptions& options){
+        for ( int i = 1 ; i < argc ; ++i ){
+            std::string arg = argv[i] ;
+            if ( i + 1 >= argc ) return false ;
+            std::string value = argv[++i] ;
+
+            if ( arg == "--render" ) options.patch = value ;
+            else if ( arg == "--midi" ) options.midi = value ;
+            else if ( arg == "--out" ) options.out = value ;
+            else if ( arg == "--seconds" ){
+                try {
+                    options.seconds = std::stod(value);
+                } catch ( const std::exception& ){
+                    return false ;
+                }
+            }
+            else return false ;
+        }
+        return !options.patch.empty() && !options.out.empty() ;
+    }
+
+    /**
+     * @brief parse the latency test flags
+     * 
+     * @return false on unknown or incomplete arguments
+     */
+    bool parseLatencyArgs(int argc, char** argv, int& notes, std::string& patch){
+        for ( int i = 1 ; i < argc ; ++i ){
+            std::string arg = argv[i] ;
+            if ( i + 1 >= argc ) return false ;
+            std::string value = argv[++i] ;
+
+            if ( arg == "--latency-test" ){
+                try {
+                    notes = std::stoi(value);
+                } catch ( const std::exception& ){
+                    return false ;
+                }
+            }
+            else if ( arg == "--patch" ) patch = value ;
+            else return false ;
+        }
+        return notes > 0 ;
+    }
+}
 
 // Program Entry Point
-int main() {
+int main(int argc, char** argv) {
     spdlog::set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%s:%#] %v");
-    spdlog::set_level(spdlog::level::debug);
+    Config::load();
+    Log::instance()->configure(); // levels per subsystem, from logging in the config
+
+    if ( argc > 1 && std::string(argv[1]) == "--latency-test" ){
+        int notes = 0 ;
+        std::string patch ;
+        if ( !parseLatencyArgs(argc, argv, notes, patch) ){
+            printUsage(argv[0]);
+            return 2 ;
+        }
+        Engine engine ;
+        return engine.latencyTest(notes, patch);
+    }
+
+    if ( argc > 1 ){
+        RenderOptions options ;
+        if ( !parseRenderArgs(argc, argv, options) ){
+            printUsage(argv[0]);
+            return 2 ;
+        }
+        Engine engine ;
+        return engine.render(options);
+    }
+
     SPDLOG_INFO("RtAudio version: " + RtAudio::getVersion());
     SPDLOG_INFO("RtMidi version: " + RtMidi::getVersion());
-    Config::load();
     Engine engine ;
     engine.initialize();
-}
\ No newline at end of file
+}
@@ -17,7 +17,7 @@
 
 #include "midi/MidiCommand.hpp"
 
-const std::string midiCommand2String(MidiCommand c){
+const char* midiCommand2String(MidiCommand c){
     switch(c){
     case MidiCommand::MIDI_CMD_NOTE_OFF: return "MIDI_CMD_NOTE_OFF";
     case MidiCommand::MIDI_CMD_NOTE_ON: return "MIDI_CMD_NOTE_ON";
@@ -31,6 +31,6 @@ enum class MidiCommand {
     MIDI_CMD_PITCHBEND        = 0xE0,
 };
 
-const std::string midiCommand2String(MidiCommand c);
+const char* midiCommand2String(MidiCommand c);
 
 #endif // MIDI_COMMAND_HPP_
\ No newline at end of file
@@ -17,6 +17,8 @@
 
 #include "midi/MidiController.hpp"
 #include "midi/MidiCommand.hpp"
+#include "diagnostics/Tracer.hpp"
+#include "diagnostics/Log.hpp"
                   
 #include <spdlog/spdlog.h>
 #include <cmath>
@@ -51,6 +53,10 @@ void MidiController::removeHandler(MidiEventHandler* handler){
     handlers_.erase(handler) ;  
 }
 
+void MidiController::setLatencyProbe(LatencyProbe* probe){
+    latencyProbe_ = probe ;
+}
+
 void MidiController::tick(float dt){
     for ( MidiEventHandler* h : handlers_ ){
         h->tick(dt);
@@ -59,6 +65,13 @@ void MidiController::tick(float dt){
 
 void MidiController::onMidiEvent(double deltaTime, std::vector<unsigned char> *message, void *userData){
     MidiController* self = static_cast<MidiController*>(userData);
+    Tracer::setThreadName("midi");
+    TRACE_SCOPE("midi_event");
+
+    // stamped before any processing, so the measurement covers all of it
+    if ( self->latencyProbe_ && message->size() >= 3 && ((*message)[0] & 0xF0) == static_cast<unsigned char>(MidiCommand::MIDI_CMD_NOTE_ON) && (*message)[2] > 0 ){
+        self->latencyProbe_->noteOn(LatencyProbe::now(), (*message)[1]);
+    }
     self->processMessage(deltaTime, message);    
 }
 
@@ -66,7 +79,7 @@ void MidiController::processMessage([[maybe_unused]] double deltaTime, std::vect
     MidiCommand command = static_cast<MidiCommand>((*message)[0] & 0xF0) ;
     int channel         = static_cast<int>((*message)[0] & 0x0F) ;
 
-    SPDLOG_INFO("MIDI Message received by midi controller: command={}, channel={}", midiCommand2String(command), channel) ;
+    LOG_RT(LogSubsystem::MIDI, spdlog::level::debug, "MIDI Message received by midi controller: command={}, channel={}", midiCommand2String(command), channel);
 
     switch(command){
         case MidiCommand::MIDI_CMD_NOTE_OFF:
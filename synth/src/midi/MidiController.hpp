@@ -23,6 +23,7 @@
 
 #include "midi/MidiState.hpp"
 #include "midi/MidiEventHandler.hpp"
+#include "diagnostics/LatencyProbe.hpp"
 
 constexpr float CONFIG_PITCHBEND_MAX_SHIFT = 2 ;
 
@@ -32,6 +33,7 @@ class MidiController {
 private:
     MidiState* state_ ;
     std::set<MidiEventHandler*> handlers_ ;
+    LatencyProbe* latencyProbe_ = nullptr ;
        
 
 public:
@@ -54,8 +56,13 @@ public:
     void addHandler(MidiEventHandler* handler);
     void removeHandler(MidiEventHandler* handler);
 
+    // note-ons are stamped on arrival for the probe to time
+    void setLatencyProbe(LatencyProbe* probe);
+
     /**
-     * @brief tick all midi handlers ( to resolve the event queue)
+     * @brief tick the handlers added here ( to resolve the event queue)
+     * 
+     * Only long-lived handlers are added, component handlers are ticked from the processing plan.
      * 
      * @param dt delta time
      */
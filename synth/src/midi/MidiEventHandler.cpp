@@ -16,6 +16,7 @@
  */
 
 #include "MidiEventHandler.hpp"
+#include "diagnostics/Log.hpp"
 #include <algorithm>
 #include <spdlog/spdlog.h>
 
@@ -138,7 +139,7 @@ void MidiEventHandler::handleKeyPressed(const MidiNote note){
 void MidiEventHandler::handleKeyReleased(const MidiNote note){
     auto anote = notes_[note.getMidiNote()] ;
     if ( ! isNoteActive(note.getMidiNote()) ){
-        SPDLOG_WARN("Received release event for midi note {}, but that note is not currently active."
+        LOG_RT(LogSubsystem::MIDI, spdlog::level::warn, "Received release event for midi note {}, but that note is not currently active."
             "This may be intentionally caused by a child class implementation.", note.getMidiNote());
     }
     anote.note = note ;
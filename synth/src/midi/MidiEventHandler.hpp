@@ -66,6 +66,7 @@ public:
     std::vector<MidiEventListener*>& getListeners();
     
     bool isNoteActive(uint8_t n) const ;
+    size_t getActiveVoices() const override { return activeCount_ ; }
     void activateNote(const ActiveNote& anote);
     void deactivateNote(uint8_t n);
 
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "midi/MidiFile.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+namespace {
+    uint32_t readBigEndian(const unsigned char* p, size_t n){
+        uint32_t v = 0 ;
+        for ( size_t i = 0 ; i < n ; ++i ) v = ( v << 8 ) | p[i] ;
+        return v ;
+    }
+
+    // variable length quantity, at most four bytes
+    bool readVarLen(const unsigned char*& p, const unsigned char* end, uint32_t& value){
+        value = 0 ;
+        for ( int i = 0 ; i < 4 ; ++i ){
+            if ( p >= end ) return false ;
+            unsigned char b = *p++ ;
+            value = ( value << 7 ) | ( b & 0x7F );
+            if ( !( b & 0x80 ) ) return true ;
+        }
+        return false ;
+    }
+
+    size_t channelDataBytes(unsigned char status){
+        unsigned char command = status & 0xF0 ;
+        return ( command == 0xC0 || command == 0xD0 ) ? 1 : 2 ;
+    }
+
+    constexpr uint32_t DEFAULT_TEMPO = 500000 ; // 120 bpm
+}
+
+bool MidiFile::load(const std::string& path){
+    events_.clear();
+
+    std::ifstream file(path, std::ios::binary);
+    if ( !file ){
+        SPDLOG_ERROR("Cannot open midi file {}", path);
+        return false ;
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if ( data.size() < 14 || !std::equal(data.begin(), data.begin() + 4, "MThd") ){
+        SPDLOG_ERROR("{} is not a standard midi file", path);
+        return false ;
+    }
+
+    uint32_t headerLength = readBigEndian(&data[4], 4);
+    uint16_t format = readBigEndian(&data[8], 2);
+    uint16_t nTracks = readBigEndian(&data[10], 2);
+    uint16_t division = readBigEndian(&data[12], 2);
+    if ( format > 1 ){
+        SPDLOG_ERROR("midi file format {} is not supported", format);
+        return false ;
+    }
+
+    std::vector<TimedMessage> messages ;
+    std::vector<TempoChange> tempos ;
+    size_t pos = 8 + headerLength ;
+    uint16_t parsed = 0 ;
+    while ( parsed < nTracks && pos + 8 <= data.size() ){
+        uint32_t length = readBigEndian(&data[pos + 4], 4);
+        size_t begin = pos + 8 ;
+        if ( begin + length > data.size() ){
+            SPDLOG_ERROR("midi file {} is truncated", path);
+            return false ;
+        }
+        // chunks other than tracks are skipped
+        if ( std::equal(data.begin() + pos, data.begin() + pos + 4, "MTrk") ){
+            if ( !parseTrack(&data[begin], length, messages, tempos) ){
+                SPDLOG_ERROR("malformed track {} in midi file {}", parsed, path);
+                return false ;
+            }
+            ++parsed ;
+        }
+        pos = begin + length ;
+    }
+
+    // tracks are merged in order, so simultaneous events keep their track order
+    auto byTick = [](const auto& a, const auto& b){ return a.tick < b.tick ; };
+    std::stable_sort(messages.begin(), messages.end(), byTick);
+    std::stable_sort(tempos.begin(), tempos.end(), byTick);
+
+    // ticks to seconds. Negative upper byte means SMPTE frames per second and ticks per frame
+    double secondsPerTick = 0.0 ;
+    bool smpte = division & 0x8000 ;
+    if ( smpte ){
+        int fps = -static_cast<int8_t>(division >> 8) ;
+        secondsPerTick = 1.0 / ( fps * ( division & 0xFF ) );
+    } else if ( division == 0 ){
+        SPDLOG_ERROR("midi file {} has no time division", path);
+        return false ;
+    }
+
+    uint32_t tempo = DEFAULT_TEMPO ;
+    uint64_t lastTick = 0 ;
+    double seconds = 0.0 ;
+    auto nextTempo = tempos.begin();
+    events_.reserve(messages.size());
+    for ( auto& m : messages ){
+        if ( !smpte ){
+            // advance across every tempo change before this event
+            while ( nextTempo != tempos.end() && nextTempo->tick <= m.tick ){
+                seconds += ( nextTempo->tick - lastTick ) * ( tempo * 1e-6 / division );
+                lastTick = nextTempo->tick ;
+                tempo = nextTempo->microsPerQuarter ;
+                ++nextTempo ;
+            }
+            seconds += ( m.tick - lastTick ) * ( tempo * 1e-6 / division );
+            lastTick = m.tick ;
+        } else {
+            seconds = m.tick * secondsPerTick ;
+        }
+        events_.push_back({seconds, std::move(m.message)});
+    }
+
+    SPDLOG_INFO("Loaded {} midi events ({:.2f} s) from {}", events_.size(), getDuration(), path);
+    return true ;
+}
+
+const std::vector<MidiFileEvent>& MidiFile::getEvents() const {
+    return events_ ;
+}
+
+double MidiFile::getDuration() const {
+    return events_.empty() ? 0.0 : events_.back().time ;
+}
+
+bool MidiFile::parseTrack(const unsigned char* p, size_t size, std::vector<TimedMessage>& messages, std::vector<TempoChange>& tempos){
+    const unsigned char* end = p + size ;
+    uint64_t tick = 0 ;
+    unsigned char running = 0 ;
+
+    while ( p < end ){
+        uint32_t delta ;
+        if ( !readVarLen(p, end, delta) || p >= end ) return false ;
+        tick += delta ;
+
+        unsigned char status = *p ;
+        if ( status == 0xFF ){
+            // meta event, only tempo and end of track matter
+            if ( end - p < 2 ) return false ;
+            unsigned char type = p[1] ;
+            p += 2 ;
+            uint32_t length ;
+            if ( !readVarLen(p, end, length) || static_cast<size_t>(end - p) < length ) return false ;
+            if ( type == 0x51 && length == 3 ) tempos.push_back({tick, readBigEndian(p, 3)});
+            p += length ;
+            if ( type == 0x2F ) return true ;
+            continue ;
+        }
+
+        if ( status == 0xF0 || status == 0xF7 ){
+            ++p ;
+            uint32_t length ;
+            if ( !readVarLen(p, end, length) || static_cast<size_t>(end - p) < length ) return false ;
+            p += length ;
+            running = 0 ;
+            continue ;
+        }
+
+        // channel message, possibly reusing the previous status byte
+        if ( status & 0x80 ){
+            running = status ;
+            ++p ;
+        } else if ( !running ){
+            return false ;
+        }
+
+        size_t nData = channelDataBytes(running);
+        if ( static_cast<size_t>(end - p) < nData ) return false ;
+
+        std::vector<unsigned char> message{running, p[0]} ;
+        if ( nData == 2 ) message.push_back(p[1]);
+        p += nData ;
+
+        // note on with zero velocity is a note off
+        if ( ( running & 0xF0 ) == 0x90 && message[2] == 0 ) message[0] = 0x80 | ( running & 0x0F );
+        messages.push_back({tick, std::move(message)});
+    }
+    return true ;
+}
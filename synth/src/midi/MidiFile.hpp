@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MIDI_FILE_HPP_
+#define __MIDI_FILE_HPP_
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct MidiFileEvent {
+    double time ; // seconds from the start of the file
+    std::vector<unsigned char> message ;
+};
+
+/**
+ * @brief reads the channel messages of a standard midi file (format 0 or 1)
+ * 
+ * Tracks are merged and tick times converted to seconds through the file's tempo map.
+ * Meta and system exclusive events are dropped.
+*/
+class MidiFile {
+private:
+    std::vector<MidiFileEvent> events_ ;
+
+public:
+    /**
+     * @brief parse the file at path, replacing any events already loaded
+     * 
+     * @return false if the file cannot be read or is not a midi file
+    */
+    bool load(const std::string& path);
+
+    /**
+     * @brief all events, ordered by time
+    */
+    const std::vector<MidiFileEvent>& getEvents() const ;
+
+    /**
+     * @brief time of the last event in seconds
+    */
+    double getDuration() const ;
+
+private:
+    struct TimedMessage {
+        uint64_t tick ;
+        std::vector<unsigned char> message ;
+    };
+
+    struct TempoChange {
+        uint64_t tick ;
+        uint32_t microsPerQuarter ;
+    };
+
+    static bool parseTrack(const unsigned char* data, size_t size, std::vector<TimedMessage>& messages, std::vector<TempoChange>& tempos);
+};
+
+#endif // __MIDI_FILE_HPP_
@@ -22,6 +22,8 @@
 #include "params/ParameterListener.hpp"
 #include "core/BaseModulator.hpp"
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cmath>
 #include <variant>
 #include <vector>
 
@@ -98,6 +100,30 @@ public:
 
     virtual void resetValue() = 0 ;
     virtual void modulate() = 0 ;
+
+    /**
+     * @brief computes this block's segment of the smoothing ramp (audio thread)
+     * 
+     * @param nFrames frames in the upcoming block
+     * @param sampleRate sample rate
+     * @return true if the parameter is ramping during this block
+     */
+    virtual bool prepareSmoothing([[maybe_unused]] size_t nFrames, [[maybe_unused]] double sampleRate){ return false ; }
+
+    /**
+     * @brief lay the rest of this block's ramp out again from the current value, after the
+     * target changed part way through the block (audio thread)
+     * 
+     * @param nFrames frames left in the block
+     * @param sampleRate sample rate
+     * @return true if the parameter is ramping for the rest of the block
+     */
+    virtual bool restartSmoothing([[maybe_unused]] size_t nFrames, [[maybe_unused]] double sampleRate){ return false ; }
+
+    /**
+     * @brief advance the smoothing ramp by one sample (audio thread)
+     */
+    virtual void advanceSmoothing(){}
     virtual Parameter<ParameterType::DEPTH>* getDepth(){ return nullptr ;}
 
     void addListener(ParameterListener* listener){
@@ -126,6 +152,11 @@ class Parameter : public ParameterBase {
     public:
         using ValueType = GET_PARAMETER_VALUE_TYPE(typ);
 
+        // only continuous values are smoothed, everything else jumps to its target
+        static constexpr bool smoothed = 
+            ParameterTraits<typ>::smoothing != SmoothingPolicy::NONE &&
+            std::is_floating_point_v<ValueType> ;
+
     private:
         ValueType minValue_ ;
         ValueType maxValue_ ;
@@ -133,6 +164,14 @@ class Parameter : public ParameterBase {
         ValueType instantaneousValue_ ;
         ValueType defaultValue_ ;
 
+        // smoothing state. target_ is written by setTargetValue, the rest is owned by the audio thread
+        ValueType target_ ;
+        ValueType rampTarget_ ;        // target the current linear ramp is heading to
+        size_t    rampRemaining_ = 0 ; // samples left in the current linear ramp
+        ValueType blockEnd_ ;          // value reached at the end of this block's segment
+        double    step_ = 0.0 ;        // per-sample increment within this block
+        size_t    stepsRemaining_ = 0 ;
+
         // fixed size container for a Parameter<ParameterType::DEPTH>, only on non-DEPTH parameters
         static constexpr size_t DEPTH_SLOT_SIZE = 512; 
 
@@ -161,7 +200,10 @@ class Parameter : public ParameterBase {
             maxValue_(maxValue),
             value_(limitToRange(defaultValue)),
             instantaneousValue_(value_),
-            defaultValue_(value_)
+            defaultValue_(value_),
+            target_(value_),
+            rampTarget_(value_),
+            blockEnd_(value_)
         {
             modStrategy_ = ParameterTraits<typ>::defaultStrategy ;
 
@@ -197,6 +239,17 @@ class Parameter : public ParameterBase {
             return value ;
         }
 
+        /**
+        * @brief limit a finite value to Parameter's range before narrowing it to ValueType
+        *
+        * @param value value from outside the engine, e.g. a shared memory slot
+        */
+        ValueType limitFromDouble(double value) const {
+            if ( value < static_cast<double>(minValue_) ) return minValue_ ;
+            if ( value > static_cast<double>(maxValue_) ) return maxValue_ ;
+            return static_cast<ValueType>(value);
+        }
+
         void resetValue(){
             setValue(defaultValue_);
         }
@@ -205,12 +258,96 @@ class Parameter : public ParameterBase {
             return value_ ;
         }
 
+        /**
+        * @brief set the value immediately, cancelling any smoothing ramp in progress
+        */
         bool setValue(ValueType value){
             value_ = limitToRange(value);
+            target_ = value_ ;
+            rampTarget_ = value_ ;
+            rampRemaining_ = 0 ;
+            stepsRemaining_ = 0 ;
             setInstantaneousValue(value_);
             return true ;
         }
 
+        ValueType getTargetValue() const {
+            return target_ ;
+        }
+
+        /**
+        * @brief set the value the parameter should smooth towards. Parameters whose
+        * traits don't declare a smoothing policy are set immediately.
+        */
+        bool setTargetValue(ValueType value){
+            if constexpr (!smoothed){
+                return setValue(value);
+            } else {
+                target_ = limitToRange(value);
+                return true ;
+            }
+        }
+
+        bool prepareSmoothing(size_t nFrames, double sampleRate) override {
+            if constexpr (!smoothed){
+                return false ;
+            } else {
+                ValueType target = target_ ;
+                if ( target == value_ || nFrames == 0 ){
+                    rampRemaining_ = 0 ;
+                    stepsRemaining_ = 0 ;
+                    return false ;
+                }
+
+                double rampSamples = std::max(1.0, ParameterTraits<typ>::smoothingMs * 0.001 * sampleRate) ;
+
+                if constexpr (ParameterTraits<typ>::smoothing == SmoothingPolicy::LINEAR){
+                    if ( target != rampTarget_ || rampRemaining_ == 0 ){
+                        rampTarget_ = target ;
+                        rampRemaining_ = static_cast<size_t>(rampSamples);
+                    }
+                    stepsRemaining_ = std::min(nFrames, rampRemaining_);
+                    step_ = (static_cast<double>(target) - value_) / rampRemaining_ ;
+                    rampRemaining_ -= stepsRemaining_ ;
+                    blockEnd_ = rampRemaining_ == 0 ? target : static_cast<ValueType>(value_ + step_ * stepsRemaining_);
+                } else {
+                    // one-pole: evaluate the exponential at the block boundary, interpolate linearly inside the block
+                    double remaining = (static_cast<double>(value_) - target) * std::exp(-static_cast<double>(nFrames) / rampSamples) ;
+                    double range = static_cast<double>(maxValue_) - minValue_ ;
+                    blockEnd_ = std::fabs(remaining) <= 1e-5 * range ? target : static_cast<ValueType>(target + remaining) ;
+                    stepsRemaining_ = nFrames ;
+                    step_ = (static_cast<double>(blockEnd_) - value_) / nFrames ;
+                }
+                return true ;
+            }
+        }
+
+        bool restartSmoothing(size_t nFrames, double sampleRate) override {
+            if constexpr (!smoothed){
+                return false ;
+            } else {
+                if constexpr (ParameterTraits<typ>::smoothing == SmoothingPolicy::LINEAR){
+                    // hand back the part of this block's segment that hasn't run
+                    rampRemaining_ += stepsRemaining_ ;
+                }
+                stepsRemaining_ = 0 ;
+                return prepareSmoothing(nFrames, sampleRate);
+            }
+        }
+
+        void advanceSmoothing() override {
+            if constexpr (smoothed){
+                if ( stepsRemaining_ == 0 ) return ;
+
+                value_ = --stepsRemaining_ == 0 ? blockEnd_ : static_cast<ValueType>(value_ + step_) ;
+                
+                // modulated parameters pick up the new base value in modulate()
+                if ( !modulatable_ || !modulator_ || modStrategy_ == ModulationStrategy::NONE ){
+                    setInstantaneousValue(value_);
+                }
+            }
+        }
+
         ValueType getMinimum() const {
             return minValue_ ;
         }
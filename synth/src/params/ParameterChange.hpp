@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PARAMETER_CHANGE_HPP_
+#define __PARAMETER_CHANGE_HPP_
+
+#include "types/ParameterType.hpp"
+#include "core/BaseComponent.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+enum class ParameterChangeType : uint8_t {
+    VALUE,    // smoothed target value of the parameter
+    JUMP,     // value applied without smoothing
+    DEPTH,    // modulation depth
+    STRATEGY  // modulation strategy
+};
+
+/**
+ * @brief a single parameter write, sent from API threads to the audio thread
+ * 
+ * Kept trivially copyable so it can travel through the lock-free parameter queue.
+ */
+struct ParameterChange {
+    ParameterChangeType type ;
+    ParameterType parameter ;
+    ComponentId componentId ;
+    uint32_t frameOffset ; // frames after the start of the block in which the change is received
+    double value ;
+};
+
+static_assert(std::is_trivially_copyable_v<ParameterChange>, "ParameterChange must be trivially copyable");
+
+#endif // __PARAMETER_CHANGE_HPP_
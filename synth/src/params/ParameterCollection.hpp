@@ -21,8 +21,12 @@
 #include "types/ParameterType.hpp"
 
 #include <spdlog/spdlog.h>
-#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <vector>
 
 class ParameterCollectionBase {
 protected:
@@ -35,22 +39,71 @@ public:
         type_(typ)
     {}
 
+    virtual ~ParameterCollectionBase() = default ;
+
     ParameterCollectionBase(const ParameterCollectionBase&) = delete;
     ParameterCollectionBase& operator=(const ParameterCollectionBase&) = delete;
+
+    virtual void sync() = 0 ;
+
+    // capture the writer-side state, the returned function restores and publishes it
+    virtual std::function<void()> checkpoint() = 0 ;
 };
 
+/*
+ParameterCollections are edited from API threads and read by the audio thread. Edits are
+made to a writer-side copy and published as an immutable snapshot; the audio thread adopts
+the newest snapshot at the start of a block (sync) and pushes the one it replaced onto a
+retire list, which the writer empties on its next edit. The audio thread therefore never
+locks, allocates or frees.
+*/
 template<ParameterType typ>
 class ParameterCollection : public ParameterCollectionBase {
 public:
     using ValueType = GET_PARAMETER_VALUE_TYPE(typ);
 
+    struct Snapshot {
+        int nextID = 0 ;
+        std::vector<int> active ;
+        std::map<int, ValueType> values ;
+        std::map<int, ValueType> defaultValues ;
+        ValueType minValue ;
+        ValueType maxValue ;
+
+        size_t size() const {
+            return values.size() ;
+        }
+
+        ValueType getValue(size_t idx) const {
+            auto it = values.find(idx);
+            return it != values.end() ? it->second : minValue ;
+        }
+
+        const std::vector<int>& getIndices() const {
+            return active ;
+        }
+
+        ValueType getMinValue() const {
+            return minValue ;
+        }
+
+        ValueType getMaxValue() const {
+            return maxValue ;
+        }
+    };
+
 private:
-    int nextID = 0 ;
-    std::vector<int> active_ ;
-    std::map<int, ValueType> values_ ;
-    ValueType minValue_ ;
-    ValueType maxValue_ ;
-    std::map<int, ValueType> defaultValues_ ;
+    struct Node {
+        Snapshot snapshot ;
+        Node* nextRetired = nullptr ;
+    };
+
+    mutable std::mutex writeMutex_ ; // serializes API-side access, never taken by the audio thread
+    Snapshot latest_ ;               // writer-side copy, always reflects every edit
+
+    Node* live_ ;                    // snapshot read by the audio thread
+    std::atomic<Node*> pending_{nullptr} ;
+    std::atomic<Node*> retired_{nullptr} ; // replaced by the audio thread, freed by the writer
 
 public:
     ParameterCollection(
@@ -59,146 +112,230 @@ public:
         ValueType maxValue = ParameterTraits<typ>::maximum
     ):
         ParameterCollectionBase(typ),
-        minValue_(minValue),
-        maxValue_(maxValue)
+        latest_()
     {
+        latest_.minValue = minValue ;
+        latest_.maxValue = maxValue ;
         for ( auto v : defaultValues ){
-            addValue(v);
-        }   
+            insert(v);
+        }
+        live_ = new Node{latest_};
     }
 
     ParameterCollection():
         ParameterCollection({}){}
 
+    ~ParameterCollection(){
+        delete live_ ;
+        delete pending_.exchange(nullptr);
+        reclaim();
+    }
+
+    // ---------------- audio thread ----------------
+
+    /**
+     * @brief adopt the most recently published snapshot. Only call from the audio thread,
+     * at a block boundary, while no references into the current snapshot are held.
+     */
+    void sync() override {
+        Node* next = pending_.exchange(nullptr, std::memory_order_acq_rel);
+        if ( !next ) return ;
+
+        // only the writer takes from the list, and it takes all of it
+        live_->nextRetired = retired_.load(std::memory_order_relaxed);
+        while ( !retired_.compare_exchange_weak(live_->nextRetired, live_, std::memory_order_release, std::memory_order_relaxed) );
+        live_ = next ;
+    }
+
+    const Snapshot& snapshot() const {
+        return live_->snapshot ;
+    }
+
+    // ---------------- API threads ----------------
+
     size_t addValue(ValueType v){
-        v = limitToRange(v);
-        values_[nextID] = v ;
-        defaultValues_[nextID] = v ;
-        active_.push_back(nextID);
-        return nextID++ ;
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        size_t idx = insert(v);
+        publish();
+        return idx ;
     }
 
     int removeValue(int idx){
-        if ( !values_.contains(idx) ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( !latest_.values.contains(idx) ){
             std::string msg = fmt::format("Cannot remove value from collection. idx {} is not in use", idx);
             SPDLOG_ERROR(msg);
             throw std::runtime_error(msg);
         }
-        values_.erase(idx);
-        defaultValues_.erase(idx);
-        active_.erase(std::remove(active_.begin(), active_.end(), idx), active_.end());
-        return values_.size();
+        latest_.values.erase(idx);
+        latest_.defaultValues.erase(idx);
+        latest_.active.erase(std::remove(latest_.active.begin(), latest_.active.end(), idx), latest_.active.end());
+        publish();
+        return latest_.values.size();
     } 
 
     size_t size() const {
-        return values_.size() ;
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return latest_.values.size() ;
     }
 
     ValueType getValue(size_t idx) const {
-        if ( ! values_.contains(idx) ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( ! latest_.values.contains(idx) ){
             std::string msg = fmt::format("Cannot get value from collection. idx {} is not in use", idx);
             SPDLOG_ERROR(msg);
             throw std::runtime_error(msg);
         }
-        return values_.at(idx) ;
+        return latest_.values.at(idx) ;
     }
 
-    const std::map<int, ValueType>& getValues() const {
-        return values_ ;
+    std::map<int, ValueType> getValues() const {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return latest_.values ;
     }
 
     bool setValue(size_t idx, ValueType v){
-        if ( ! values_.contains(idx) ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( ! latest_.values.contains(idx) ){
             SPDLOG_ERROR("Cannot set value in collection. idx {} is not in use", idx);
             return false ;
         }
-        values_[idx] = limitToRange(v);
+        latest_.values[idx] = limitToRange(v);
+        publish();
         return true ;
     }
 
     ValueType getDefaultValue(size_t idx) const {
-        if ( ! defaultValues_.contains(idx) ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( ! latest_.defaultValues.contains(idx) ){
             std::string msg = fmt::format("Cannot get default value from collection. idx {} is not in use", idx);
             SPDLOG_ERROR(msg);
             throw std::runtime_error(msg);
         }
-        return defaultValues_[idx] ;
+        return latest_.defaultValues.at(idx) ;
     }
 
     void setDefaultValue(size_t idx, ValueType v){
-        if ( ! defaultValues_.contains(idx) ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( ! latest_.defaultValues.contains(idx) ){
             SPDLOG_ERROR("Cannot set default value in collection. idx {} is not in use", idx);
             return ;
         }
-        defaultValues_[idx] = limitToRange(v);
+        latest_.defaultValues[idx] = limitToRange(v);
+        publish();
     }
 
     void resetValue(size_t idx){
-        if ( ! values_.contains(idx) ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( ! latest_.values.contains(idx) ){
             SPDLOG_ERROR("Cannot set value in collection. idx {} is not in use", idx);
             return ;
         }
-        values_[idx] = defaultValues_[idx] ;
+        latest_.values[idx] = latest_.defaultValues[idx] ;
+        publish();
     }
 
     ValueType getMinValue() const {
-        return minValue_ ;
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return latest_.minValue ;
     }
 
     bool setMinValue(ValueType v){
-        if ( v > maxValue_ ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( v > latest_.maxValue ){
             SPDLOG_ERROR("Cannot set minimum value higher than maximum value.");
             return false ;
         }
-        minValue_ = v ;
+        latest_.minValue = v ;
+        publish();
         return true ;
     }
 
     ValueType getMaxValue() const {
-        return maxValue_ ;
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return latest_.maxValue ;
     }
 
     bool setMaxValue(ValueType v){
-        if ( v < minValue_ ){
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if ( v < latest_.minValue ){
             SPDLOG_ERROR("Cannot set maximum value higher than minimum value");
             return false ;
         }
-        maxValue_ = v ;
+        latest_.maxValue = v ;
+        publish();
         return true ;
     }
 
     void setValueRange(ValueType min, ValueType max){
+        std::lock_guard<std::mutex> lock(writeMutex_);
         if ( min > max ){
             SPDLOG_ERROR("Cannot set maximum value higher than minimum value");
             return ;
         }
-        minValue_ = min ;
-        maxValue_ = max ;
+        latest_.minValue = min ;
+        latest_.maxValue = max ;
+        publish();
     }
 
     void reset(){
-        values_ = defaultValues_ ;
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        latest_.values = latest_.defaultValues ;
+        publish();
     }
 
     void clear(){
-        values_.clear();
-        defaultValues_.clear();
-        active_.clear();
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        latest_.values.clear();
+        latest_.defaultValues.clear();
+        latest_.active.clear();
+        publish();
     }
 
-    void reserve(size_t capacity){
-        values_.reserve(capacity);
-        defaultValues_.reserve(capacity);
+    std::vector<int> getIndices() const {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return latest_.active ;
     }
 
-    const std::vector<int>& getIndices() const {
-        return active_ ;
+    std::function<void()> checkpoint() override {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        return [this, saved = latest_](){
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            latest_ = saved ;
+            publish();
+        };
     }
 
 private:
+    size_t insert(ValueType v){
+        v = limitToRange(v);
+        latest_.values[latest_.nextID] = v ;
+        latest_.defaultValues[latest_.nextID] = v ;
+        latest_.active.push_back(latest_.nextID);
+        return latest_.nextID++ ;
+    }
+
+    // copy the writer-side state into a new snapshot for the audio thread (writeMutex_ held)
+    void publish(){
+        reclaim();
+
+        Node* replaced = pending_.exchange(new Node{latest_}, std::memory_order_acq_rel);
+        delete replaced ; // never adopted by the audio thread
+    }
+
+    // free every snapshot the audio thread has replaced so far
+    void reclaim(){
+        Node* node = retired_.exchange(nullptr, std::memory_order_acquire);
+        while ( node ){
+            Node* next = node->nextRetired ;
+            delete node ;
+            node = next ;
+        }
+    }
+
     ValueType limitToRange(ValueType value) const {
-            if ( value < minValue_ ) return minValue_ ;
-            if ( value > maxValue_ ) return maxValue_ ;
+            if ( value < latest_.minValue ) return latest_.minValue ;
+            if ( value > latest_.maxValue ) return latest_.maxValue ;
             return value ;
         }
 };
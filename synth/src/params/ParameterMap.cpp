@@ -17,9 +17,13 @@
 
 #include "params/ParameterMap.hpp"
 
+#include "dsp/math.hpp"
+
 ParameterMap::ParameterMap():
     modulatable_(),
-    reference_()
+    reference_(),
+    smoothed_(),
+    sampleRate_(Config::get<double>("audio.sample_rate").value_or(48000.0))
 {}
 
 ParameterBase* ParameterMap::getParameter(ParameterType p) const {
@@ -44,11 +48,35 @@ void ParameterMap::addReferences(ParameterMap& other){
     }
 }
 
-std::set<ParameterType> ParameterMap::getModulatableParameters() const {
+const std::set<ParameterType>& ParameterMap::getModulatableParameters() const {
     return modulatable_ ;
 }
 
-void ParameterMap::modulate(){
+void ParameterMap::prepareBlock(size_t nFrames, bool syncCollections){
+    if ( has_collections && syncCollections ){
+        for ( auto* c : collections_ ){
+            if ( c ) c->sync();
+        }
+    }
+
+    activeRamps_ = 0 ;
+    for ( auto* p : smoothed_ ){
+        if ( p->prepareSmoothing(nFrames, sampleRate_) ) ++activeRamps_ ;
+    }
+}
+
+void ParameterMap::restartSmoothing(ParameterType p, size_t nFrames){
+    ParameterBase* param = getParameter(p);
+    if ( !param || reference_.count(p) ) return ;
+    if ( param->restartSmoothing(nFrames, sampleRate_) && activeRamps_ == 0 ) activeRamps_ = 1 ;
+}
+
+void ParameterMap::modulate(bool control){
+    if ( activeRamps_ > 0 ){
+        for ( auto* p : smoothed_ ) p->advanceSmoothing();
+    }
+    if ( !control ) return ;
+
     for (auto it = modulatable_.begin(); it != modulatable_.end(); ++it ){
         modulateParameter(*it);
     }
@@ -56,16 +84,34 @@ void ParameterMap::modulate(){
 
 json ParameterMap::getValueDispatch(ParameterType p) const {
     switch (p) {
-        #define X(NAME) case ParameterType::NAME: return ParameterValueToJson(getParameter<ParameterType::NAME>()->getValue());
+        #define X(NAME) case ParameterType::NAME: return ParameterValueToJson(getParameter<ParameterType::NAME>()->getTargetValue());
         PARAMETER_TYPE_LIST
         #undef X
         default: throw std::runtime_error("Invalid Parameter dispatch");
     }
 }
 
-bool ParameterMap::setValueDispatch(ParameterType p, const json& value){
+double ParameterMap::getInstantaneousDispatch(ParameterType p) const {
+    if ( !getParameter(p) ) return 0.0 ;
+
+    switch (p) {
+        #define X(NAME) case ParameterType::NAME: return static_cast<double>(getParameter<ParameterType::NAME>()->getInstantaneousValue());
+        PARAMETER_TYPE_LIST
+        #undef X
+        default: return 0.0 ;
+    }
+}
+
+bool ParameterMap::setTargetDispatch(ParameterType p, double value, bool smooth){
+    // narrowing NaN or an out of range double to an integral ValueType is undefined.
+    // msgpack and cbor carry NaN and Inf, see dsp::isFinite for why isfinite won't do
+    if ( !getParameter(p) || !dsp::isFinite(value) ) return false ;
+
     switch (p){
-        #define X(NAME) case ParameterType::NAME: return getParameter<ParameterType::NAME>()->setValue(value);
+        #define X(NAME) case ParameterType::NAME: \
+            return smooth ? \
+                getParameter<ParameterType::NAME>()->setTargetValue(getParameter<ParameterType::NAME>()->limitFromDouble(value)) : \
+                getParameter<ParameterType::NAME>()->setValue(getParameter<ParameterType::NAME>()->limitFromDouble(value));
         PARAMETER_TYPE_LIST
         #undef X
     default:
@@ -73,6 +119,18 @@ bool ParameterMap::setValueDispatch(ParameterType p, const json& value){
     }
 }
 
+json ParameterMap::limitValueDispatch(ParameterType p, const json& value) const {
+    if ( !getParameter(p) ) throw std::runtime_error("Parameter not found in component");
+
+    switch (p) {
+        #define X(NAME) case ParameterType::NAME: \
+            return ParameterValueToJson(getParameter<ParameterType::NAME>()->limitToRange(value.get<GET_PARAMETER_VALUE_TYPE(ParameterType::NAME)>()));
+        PARAMETER_TYPE_LIST
+        #undef X
+        default: throw std::runtime_error("Invalid Parameter dispatch");
+    }
+}
+
 json ParameterMap::getDefaultDispatch(ParameterType p) const {
     switch (p) {
         #define X(NAME) case ParameterType::NAME: return ParameterValueToJson(getParameter<ParameterType::NAME>()->getDefaultValue());
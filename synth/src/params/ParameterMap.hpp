@@ -50,6 +50,10 @@ class ParameterMap {
         bool has_collections = false ;
         collections collections_{} ;
 
+        std::vector<ParameterBase*> smoothed_ ; // owned parameters declaring a SmoothingPolicy
+        size_t activeRamps_ = 0 ;
+        double sampleRate_ ;
+
     public:
         ParameterMap();
 
@@ -58,12 +62,16 @@ class ParameterMap {
 
         void addReferences(ParameterMap& other);
 
-        std::set<ParameterType> getModulatableParameters() const ;
-        void modulate();
+        const std::set<ParameterType>& getModulatableParameters() const ;
+        void prepareBlock(size_t nFrames, bool syncCollections = true);
+        void restartSmoothing(ParameterType p, size_t nFrames); // target changed with nFrames of the block left
+        void modulate(bool control = true); // without control only smoothing advances
         
         // Parameter Dispatcher Functions
         json getValueDispatch(ParameterType p) const ;
-        bool setValueDispatch(ParameterType p, const json& value);
+        double getInstantaneousDispatch(ParameterType p) const ; // modulated value as seen by the audio thread
+        bool setTargetDispatch(ParameterType p, double value, bool smooth = true); // ramps per the smoothing policy, or jumps without smooth
+        json limitValueDispatch(ParameterType p, const json& value) const ;
         json getDefaultDispatch(ParameterType p) const ;
         bool setDefaultDispatch(ParameterType p, const json& value);
         json getMinDispatch(ParameterType p) const ;
@@ -119,6 +127,7 @@ class ParameterMap {
             Parameter<typ>* p = new Parameter<typ>(defaultValue, modulatable, minValue, maxValue, modulator, modData);
             parameters_[static_cast<size_t>(typ)] = p ;
             if (modulatable) modulatable_.insert(typ);
+            if constexpr (Parameter<typ>::smoothed) smoothed_.push_back(p);
         }
 
         template <ParameterType typ>
@@ -134,6 +143,7 @@ class ParameterMap {
 
             ParameterCollection<typ>* c = new ParameterCollection<typ>(defaultValues, minValue, maxValue);
             collections_[static_cast<size_t>(typ)] = c ;
+            has_collections = true ;
         }
 
     private:
@@ -0,0 +1,34 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __RENDER_OPTIONS_HPP_
+#define __RENDER_OPTIONS_HPP_
+
+#include <string>
+
+/**
+ * @brief what the headless renderer plays and where it writes
+*/
+struct RenderOptions {
+    std::string patch ; // configuration saved from the gui
+    std::string midi ; // optional standard midi file
+    std::string out ;
+    double seconds = 0.0 ; // 0 renders the midi file plus a release tail
+    double tail = 2.0 ;
+};
+
+#endif // __RENDER_OPTIONS_HPP_
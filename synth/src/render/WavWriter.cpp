@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "render/WavWriter.hpp"
+
+#include <limits>
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 3 ;
+    constexpr size_t HEADER_BYTES = 58 ; // RIFF, fmt (18 bytes) and fact chunks, data chunk header
+
+    void put16(unsigned char*& p, uint16_t v){
+        *p++ = v & 0xFF ; *p++ = v >> 8 ;
+    }
+
+    void put32(unsigned char*& p, uint32_t v){
+        for ( int i = 0 ; i < 4 ; ++i ) *p++ = ( v >> ( 8 * i ) ) & 0xFF ;
+    }
+
+    void putTag(unsigned char*& p, const char* tag){
+        for ( int i = 0 ; i < 4 ; ++i ) *p++ = tag[i] ;
+    }
+}
+
+WavWriter::~WavWriter(){
+    close();
+}
+
+bool WavWriter::open(const std::string& path, uint32_t sampleRate, uint16_t channels){
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if ( !file_ ){
+        SPDLOG_ERROR("Cannot open {} for writing", path);
+        return false ;
+    }
+
+    ioBuffer_.resize(IO_BUFFER_BYTES);
+    std::setvbuf(file_, ioBuffer_.data(), _IOFBF, ioBuffer_.size());
+    sampleRate_ = sampleRate ;
+    channels_ = channels ;
+    frames_ = 0 ;
+    return writeHeader();
+}
+
+bool WavWriter::write(const double* data, size_t nFrames){
+    if ( !file_ ) return false ;
+
+    size_t n = nFrames * channels_ ;
+    if ( scratch_.size() < n ) scratch_.resize(n);
+    for ( size_t i = 0 ; i < n ; ++i ) scratch_[i] = static_cast<float>(data[i]);
+
+    // host byte order, little endian on every platform we build for
+    if ( std::fwrite(scratch_.data(), sizeof(float), n, file_) != n ){
+        SPDLOG_ERROR("Error writing wav data");
+        return false ;
+    }
+    frames_ += nFrames ;
+    return true ;
+}
+
+bool WavWriter::close(){
+    if ( !file_ ) return true ;
+
+    bool ok = std::fseek(file_, 0, SEEK_SET) == 0 && writeHeader() ;
+    ok = std::fclose(file_) == 0 && ok ;
+    file_ = nullptr ;
+    if ( !ok ) SPDLOG_ERROR("Error finalizing wav file");
+    return ok ;
+}
+
+uint64_t WavWriter::getFrames() const {
+    return frames_ ;
+}
+
+bool WavWriter::writeHeader(){
+    uint64_t dataBytes = frames_ * channels_ * sizeof(float) ;
+    if ( dataBytes > std::numeric_limits<uint32_t>::max() - HEADER_BYTES ){
+        SPDLOG_WARN("wav data exceeds 4 GiB, chunk sizes are truncated");
+        dataBytes = std::numeric_limits<uint32_t>::max() - HEADER_BYTES ;
+    }
+    uint16_t blockAlign = channels_ * sizeof(float) ;
+
+    unsigned char header[HEADER_BYTES] ;
+    unsigned char* p = header ;
+    putTag(p, "RIFF");
+    put32(p, HEADER_BYTES - 8 + dataBytes);
+    putTag(p, "WAVE");
+
+    putTag(p, "fmt ");
+    put32(p, 18);
+    put16(p, WAVE_FORMAT_IEEE_FLOAT);
+    put16(p, channels_);
+    put32(p, sampleRate_);
+    put32(p, sampleRate_ * blockAlign);
+    put16(p, blockAlign);
+    put16(p, 8 * sizeof(float));
+    put16(p, 0);
+
+    // non-PCM formats carry the frame count in a fact chunk
+    putTag(p, "fact");
+    put32(p, 4);
+    put32(p, dataBytes / blockAlign);
+
+    putTag(p, "data");
+    put32(p, dataBytes);
+
+    return std::fwrite(header, 1, HEADER_BYTES, file_) == HEADER_BYTES ;
+}
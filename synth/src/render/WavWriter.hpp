@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WAV_WRITER_HPP_
+#define __WAV_WRITER_HPP_
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief streams 32-bit float samples to a WAV file
+ * 
+ * Samples go through a large stdio buffer. The header is written with placeholder sizes
+ * on open and patched on close.
+*/
+class WavWriter {
+private:
+    std::FILE* file_ = nullptr ;
+    std::vector<char> ioBuffer_ ;
+    std::vector<float> scratch_ ;
+    uint32_t sampleRate_ = 0 ;
+    uint16_t channels_ = 1 ;
+    uint64_t frames_ = 0 ;
+
+public:
+    static constexpr size_t IO_BUFFER_BYTES = 1 << 20 ;
+
+    WavWriter() = default ;
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete ;
+    WavWriter& operator=(const WavWriter&) = delete ;
+
+    bool open(const std::string& path, uint32_t sampleRate, uint16_t channels = 1);
+
+    /**
+     * @brief append interleaved frames
+    */
+    bool write(const double* data, size_t nFrames);
+
+    /**
+     * @brief fill in the chunk sizes and close the file
+    */
+    bool close();
+
+    uint64_t getFrames() const ;
+
+private:
+    bool writeHeader();
+};
+
+#endif // __WAV_WRITER_HPP_
@@ -0,0 +1,254 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __DYNAMIC_TOPOLOGY_HPP_
+#define __DYNAMIC_TOPOLOGY_HPP_
+
+#include "core/BaseModule.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief topological order of the module graph, maintained incrementally
+ * 
+ * Implements the Pearce-Kelly dynamic topological sort. Inserting an edge that already
+ * agrees with the current order is O(1); otherwise only the nodes between the two
+ * endpoints' positions that are reachable from them are visited and reordered. Removing
+ * an edge never invalidates the order. Edges that would close a cycle are rejected
+ * without modifying the graph.
+ * 
+ * Parallel edges (e.g. two cables between the same modules) are kept as duplicates.
+ */
+class DynamicTopology {
+private:
+    struct Vertex {
+        BaseModule* module = nullptr ;
+        size_t ord = 0 ; // position in order_
+        bool visited = false ;
+        std::vector<size_t> succ ;
+        std::vector<size_t> pred ;
+    };
+
+    std::vector<Vertex> vertices_ ;
+    std::vector<size_t> freeSlots_ ;
+    std::unordered_map<BaseModule*, size_t> slots_ ;
+    std::vector<size_t> order_ ; // order_[i] is the vertex at position i
+
+    // scratch space reused between edits
+    std::vector<size_t> deltaF_ ;
+    std::vector<size_t> deltaB_ ;
+    std::vector<size_t> positions_ ;
+
+public:
+    DynamicTopology() = default ;
+
+    size_t size() const {
+        return order_.size() ;
+    }
+
+    bool contains(BaseModule* m) const {
+        return slots_.count(m) > 0 ;
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1) ;
+
+    size_t positionOf(BaseModule* m) const {
+        auto it = slots_.find(m);
+        return it == slots_.end() ? npos : vertices_[it->second].ord ;
+    }
+
+    // module at position i of the order
+    BaseModule* at(size_t i) const {
+        return vertices_[order_[i]].module ;
+    }
+
+    // positions of the direct successors of the module at position i
+    template <typename F>
+    void forEachSuccessor(size_t i, F&& f) const {
+        for ( size_t s : vertices_[order_[i]].succ ) f(vertices_[s].ord);
+    }
+
+    void addNode(BaseModule* m){
+        slotOf(m);
+    }
+
+    /**
+     * @brief remove a module and all of its edges
+     */
+    void removeNode(BaseModule* m){
+        auto it = slots_.find(m);
+        if ( it == slots_.end() ) return ;
+        size_t v = it->second ;
+
+        for ( size_t s : vertices_[v].succ ) eraseOne(vertices_[s].pred, v);
+        for ( size_t p : vertices_[v].pred ) eraseOne(vertices_[p].succ, v);
+
+        size_t pos = vertices_[v].ord ;
+        order_.erase(order_.begin() + pos);
+        for ( size_t i = pos ; i < order_.size() ; ++i ) vertices_[order_[i]].ord = i ;
+
+        vertices_[v] = Vertex{} ;
+        freeSlots_.push_back(v);
+        slots_.erase(it);
+    }
+
+    /**
+     * @brief whether adding from -> to would close a cycle
+     */
+    bool createsCycle(BaseModule* from, BaseModule* to){
+        if ( from == to ) return true ;
+        auto fi = slots_.find(from);
+        auto ti = slots_.find(to);
+        if ( fi == slots_.end() || ti == slots_.end() ) return false ;
+
+        size_t x = fi->second, y = ti->second ;
+        if ( vertices_[x].ord < vertices_[y].ord ) return false ;
+
+        deltaF_.clear();
+        bool cycle = !searchForward(y, vertices_[x].ord);
+        clearVisited(deltaF_);
+        return cycle ;
+    }
+
+    /**
+     * @brief add the edge from -> to (from is processed before to)
+     * 
+     * @return false if the edge would create a cycle, in which case nothing changes
+     */
+    bool addEdge(BaseModule* from, BaseModule* to){
+        if ( from == to ) return false ;
+        size_t x = slotOf(from);
+        size_t y = slotOf(to);
+
+        size_t lb = vertices_[y].ord ;
+        size_t ub = vertices_[x].ord ;
+        if ( lb < ub ){
+            // the edge contradicts the current order, repair the affected region
+            deltaF_.clear();
+            if ( !searchForward(y, ub) ){
+                clearVisited(deltaF_);
+                return false ;
+            }
+            deltaB_.clear();
+            searchBackward(x, lb);
+            reorder();
+        }
+
+        vertices_[x].succ.push_back(y);
+        vertices_[y].pred.push_back(x);
+        return true ;
+    }
+
+    void removeEdge(BaseModule* from, BaseModule* to){
+        auto fi = slots_.find(from);
+        auto ti = slots_.find(to);
+        if ( fi == slots_.end() || ti == slots_.end() ) return ;
+        eraseOne(vertices_[fi->second].succ, ti->second);
+        eraseOne(vertices_[ti->second].pred, fi->second);
+    }
+
+    void clear(){
+        vertices_.clear();
+        freeSlots_.clear();
+        slots_.clear();
+        order_.clear();
+    }
+
+private:
+    size_t slotOf(BaseModule* m){
+        auto it = slots_.find(m);
+        if ( it != slots_.end() ) return it->second ;
+
+        size_t v ;
+        if ( freeSlots_.empty() ){
+            v = vertices_.size();
+            vertices_.emplace_back();
+        } else {
+            v = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+        vertices_[v].module = m ;
+        vertices_[v].ord = order_.size();
+        order_.push_back(v);
+        slots_.emplace(m, v);
+        return v ;
+    }
+
+    // visit successors of v positioned before ub; false if the vertex at ub is reached
+    bool searchForward(size_t v, size_t ub){
+        vertices_[v].visited = true ;
+        deltaF_.push_back(v);
+        for ( size_t w : vertices_[v].succ ){
+            size_t ord = vertices_[w].ord ;
+            if ( ord == ub ) return false ;
+            if ( !vertices_[w].visited && ord < ub ){
+                if ( !searchForward(w, ub) ) return false ;
+            }
+        }
+        return true ;
+    }
+
+    // visit predecessors of v positioned after lb
+    void searchBackward(size_t v, size_t lb){
+        vertices_[v].visited = true ;
+        deltaB_.push_back(v);
+        for ( size_t w : vertices_[v].pred ){
+            if ( !vertices_[w].visited && vertices_[w].ord > lb ){
+                searchBackward(w, lb);
+            }
+        }
+    }
+
+    // place the ancestors of the new edge's source ahead of the descendants of its target,
+    // reusing the positions both sets already occupy
+    void reorder(){
+        auto byOrd = [this](size_t a, size_t b){ return vertices_[a].ord < vertices_[b].ord ; };
+        std::sort(deltaB_.begin(), deltaB_.end(), byOrd);
+        std::sort(deltaF_.begin(), deltaF_.end(), byOrd);
+
+        positions_.clear();
+        for ( size_t v : deltaB_ ) positions_.push_back(vertices_[v].ord);
+        for ( size_t v : deltaF_ ) positions_.push_back(vertices_[v].ord);
+        std::sort(positions_.begin(), positions_.end());
+
+        size_t i = 0 ;
+        for ( size_t v : deltaB_ ) place(v, positions_[i++]);
+        for ( size_t v : deltaF_ ) place(v, positions_[i++]);
+
+        clearVisited(deltaB_);
+        clearVisited(deltaF_);
+    }
+
+    void place(size_t v, size_t pos){
+        vertices_[v].ord = pos ;
+        order_[pos] = v ;
+    }
+
+    void clearVisited(const std::vector<size_t>& vs){
+        for ( size_t v : vs ) vertices_[v].visited = false ;
+    }
+
+    static void eraseOne(std::vector<size_t>& v, size_t value){
+        auto it = std::find(v.begin(), v.end(), value);
+        if ( it != v.end() ) v.erase(it);
+    }
+};
+
+#endif // __DYNAMIC_TOPOLOGY_HPP_
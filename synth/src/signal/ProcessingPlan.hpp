@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2026 Jared Burton
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PROCESSING_PLAN_HPP_
+#define __PROCESSING_PLAN_HPP_
+
+#include "containers/BufferArena.hpp"
+#include "core/BaseModule.hpp"
+#include "midi/MidiEventHandler.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief flattened, immutable description of one audio block's work
+ * 
+ * Built from the SignalChain on an API thread and handed to the audio thread as a whole,
+ * so the audio thread never walks the graph containers while they are being edited.
+ * Modules that do not reach a sink are left out entirely, stateless modules fed nothing
+ * but silence are bound to zeros instead of processed, and chains of constant gain
+ * stages are folded into the step of their last stage.
+ * 
+ * Output buffers come from one arena owned by the plan. Outputs that are only read by
+ * later steps within the same frame share slots once their last reader has run, the way
+ * a register allocator reuses registers.
+ */
+struct ProcessingPlan {
+    static constexpr uint32_t OWN_STORAGE = UINT32_MAX ;
+    static constexpr uint32_t SILENT = UINT32_MAX - 1 ;
+    static constexpr uint32_t NO_INPUTS = UINT32_MAX ;
+
+    struct Step {
+        BaseModule* module ;
+        uint32_t sinkMask ;      // bit i set if output i is summed into the master output
+        uint32_t gainBegin = 0 ; // folded gain chain [gainBegin, gainEnd) in gains, empty if not folded
+        uint32_t gainEnd = 0 ;
+        uint32_t slots = OWN_STORAGE ; // first of the module's outputs in slots
+    };
+
+    struct Binding {
+        BaseModule* module ;
+        uint32_t slots ; // OWN_STORAGE for modules outside the plan, SILENT for elided ones
+        uint32_t inputs = NO_INPUTS ; // the module's first entry in inputBounds, if it reads its inputs
+    };
+
+    std::vector<Step> steps ;                // in processing order
+    std::vector<BaseModule*> gains ;         // folded chains, first stage to last
+    std::vector<BaseModule*> generative ;    // modules whose buffers are cleared every block
+    std::vector<BaseModule*> elided ;        // stateless modules fed only silence, never processed
+    std::vector<BaseComponent*> parameters ; // components whose parameters are updated every frame
+    size_t audioRateParameters = 0 ;         // leading parameters entries modulated by a signal module
+    std::vector<BaseComponent*> components ; // every component by id, null for removed ones
+    std::vector<MidiEventHandler*> midiHandlers ; // ticked once per block
+
+    std::unique_ptr<BufferArena> arena ;
+    std::vector<double*> slots ;    // output buffers, per step output
+    std::vector<double*> zeros ;    // silence, wide enough for any module's outputs
+    std::vector<Binding> bindings ; // every module, applied when the plan is adopted
+    std::vector<PlannedInput> inputs ; // signal connections of every module that reads its inputs
+    std::vector<uint32_t> inputBounds ; // per such module, nInputs + 1 offsets into inputs
+    size_t frames = 0 ;             // frames per buffer
+    size_t sharedOutputs = 0 ;      // outputs placed in a slot another output also uses
+};
+
+#endif // __PROCESSING_PLAN_HPP_
@@ -19,7 +19,10 @@
 #define __SIGNAL_CHAIN_HPP_
 
 #include "core/BaseModule.hpp"
+#include "signal/DynamicTopology.hpp"
 
+#include <algorithm>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <spdlog/spdlog.h>
@@ -31,9 +34,24 @@ class SignalChain {
 private:
     std::unordered_set<SignalConnection, ConnectionHash> outputNodes_ ;
     std::vector<BaseModule*> topologicalOrder_ ;
-    std::unordered_set<BaseModule*> visited_  ;
 
-    std::unordered_set<BaseModule*> modulatorOnly_ ;
+    // every connected module, kept in a valid order as edges come and go
+    DynamicTopology topology_ ;
+    // modulating modules currently entered as edges, per modulated module
+    std::unordered_map<BaseModule*, std::vector<BaseModule*>> modulationEdges_ ;
+    std::vector<char> live_ ;
+
+    // signal edges that close a cycle. They are left out of the ordering, so the
+    // consumer runs first and reads the source's previous sample
+    struct FeedbackEdge {
+        BaseModule* from ;
+        size_t fromIdx ;
+        BaseModule* to ;
+        size_t toIdx ;
+
+        bool operator==(const FeedbackEdge& other) const = default ;
+    };
+    std::vector<FeedbackEdge> feedback_ ;
 
 public:
     SignalChain():
@@ -59,6 +77,7 @@ public:
             return ;
         }
         outputNodes_.insert({output, index});
+        topology_.addNode(output);
     }
 
     void removeSink(BaseModule* output, size_t index){
@@ -70,55 +89,168 @@ public:
         outputNodes_.erase({output, index});
     }
 
-    void calculateTopologicalOrder(){
-        visited_.clear();
-        topologicalOrder_.clear();
-        
-        // global post-order depth-first search
-        for ( const auto& conn : outputNodes_ ){
-            topologicalSort(conn.module, visited_, topologicalOrder_);
+    /**
+     * @brief enter a signal edge into the ordering
+     * 
+     * @return false if the edge would create a cycle
+     */
+    bool addEdge(BaseModule* from, BaseModule* to){
+        return topology_.addEdge(from, to);
+    }
+
+    bool createsCycle(BaseModule* from, BaseModule* to){
+        return topology_.createsCycle(from, to);
+    }
+
+    void addFeedback(BaseModule* from, size_t fromIdx, BaseModule* to, size_t toIdx){
+        topology_.addNode(from);
+        topology_.addNode(to);
+        feedback_.push_back({from, fromIdx, to, toIdx});
+    }
+
+    bool isFeedbackSource(BaseModule* module) const {
+        return std::any_of(feedback_.begin(), feedback_.end(), [module](const FeedbackEdge& e){ return e.from == module ; });
+    }
+
+    // a stateful modulator, read by its targets' parameters outside the signal order
+    bool isModulationSource(BaseModule* module) const {
+        for ( const auto& [target, sources] : modulationEdges_ ){
+            if ( std::find(sources.begin(), sources.end(), module) != sources.end() ) return true ;
         }
+        return false ;
     }
 
-    void reset(){
-        outputNodes_.clear();
-        visited_.clear();
-        topologicalOrder_.clear();
+    template <typename F>
+    void forEachFeedback(F&& f) const {
+        for ( const auto& e : feedback_ ) f(e.from, e.fromIdx, e.to, e.toIdx);
     }
 
-    
+    bool isFeedback(BaseModule* from, size_t fromIdx, BaseModule* to, size_t toIdx) const {
+        return std::find(feedback_.begin(), feedback_.end(), FeedbackEdge{from, fromIdx, to, toIdx}) != feedback_.end() ;
+    }
+
+    /**
+     * @brief remove a signal edge, feedback or not
+     * 
+     * Removing an ordered edge can open the cycle a feedback edge was closing. Those are
+     * promoted back into the ordering, otherwise the delay they stand for would depend
+     * on wherever the order happens to place the two modules.
+     */
+    void removeSignalEdge(BaseModule* from, size_t fromIdx, BaseModule* to, size_t toIdx){
+        auto it = std::find(feedback_.begin(), feedback_.end(), FeedbackEdge{from, fromIdx, to, toIdx});
+        if ( it != feedback_.end() ){
+            feedback_.erase(it);
+            return ;
+        }
+        topology_.removeEdge(from, to);
+        promoteFeedback();
+    }
+
+    void promoteFeedback(){
+        for ( auto it = feedback_.begin() ; it != feedback_.end() ; ){
+            if ( topology_.addEdge(it->from, it->to) ){
+                it->to->setFeedback(it->from, it->toIdx, it->fromIdx, false);
+                it = feedback_.erase(it);
+            } else {
+                ++it ;
+            }
+        }
+    }
 
-private:
     /**
-     * @brief calculate the DAG via depth-first traversal from module to its inputs
+     * @brief bring the module's modulation edges in line with its modulation inputs
      * 
-     * @param module module pointer
-     * @param visited tracks visits during traversal
-     * @param result resulting ordered vector
+     * @return false if a new modulation input would create a cycle. That input is left out.
      */
-    void topologicalSort(
-        BaseModule* module, 
-        std::unordered_set<BaseModule*>& visited,
-        std::vector<BaseModule*>& result    
-    ){
-        if (visited.count(module)) return ;
-        visited.insert(module);
-
-        // Process stateful modulators in signal chain (e.g., Oscillator)
-        for (BaseModule* m : module->getModulationInputs() ){
-            topologicalSort(m, visited, result);
+    bool syncModulationEdges(BaseModule* target){
+        auto& registered = modulationEdges_[target] ;
+        const auto& current = target->getModulationInputs();
+        bool ok = true ;
+        bool removed = false ;
+
+        for ( auto it = registered.begin() ; it != registered.end() ; ){
+            if ( current.count(*it) ){
+                ++it ;
+                continue ;
+            }
+            topology_.removeEdge(*it, target);
+            it = registered.erase(it);
+            removed = true ;
+        }
+
+        for ( BaseModule* m : current ){
+            if ( std::find(registered.begin(), registered.end(), m) != registered.end() ) continue ;
+            if ( topology_.addEdge(m, target) ){
+                registered.push_back(m);
+            } else {
+                ok = false ;
+            }
         }
 
-        // Now process normal signal chain
-        for ( size_t i = 0; i < module->getNumInputs(); ++i ){
-            for ( const auto& conn : module->getInputs(i)){
-                topologicalSort(conn.module, visited, result);
+        if ( registered.empty() ) modulationEdges_.erase(target);
+        if ( removed ) promoteFeedback();
+        return ok ;
+    }
+
+    void removeModule(BaseModule* module){
+        topology_.removeNode(module);
+        modulationEdges_.erase(module);
+        for ( auto& [target, sources] : modulationEdges_ ){
+            sources.erase(std::remove(sources.begin(), sources.end(), module), sources.end());
+        }
+        std::erase_if(feedback_, [module](const FeedbackEdge& e){ return e.from == module || e.to == module ; });
+        promoteFeedback();
+    }
+
+    /**
+     * @brief collect, in order, every module that contributes to a sink
+     * 
+     * The order itself is maintained incrementally; this is a reverse pass that marks a
+     * module live if it is a sink or feeds a live module. A feedback edge into a live module
+     * makes its source live too, which needs another pass for that source's own inputs.
+     */
+    void calculateTopologicalOrder(){
+        size_t n = topology_.size();
+        live_.assign(n, 0);
+        topologicalOrder_.clear();
+
+        std::unordered_set<BaseModule*> sinks ;
+        for ( const auto& conn : outputNodes_ ) sinks.insert(conn.module);
+
+        bool changed = true ;
+        while ( changed ){
+            for ( size_t i = n ; i-- > 0 ; ){
+                if ( live_[i] ) continue ;
+                if ( sinks.count(topology_.at(i)) ){
+                    live_[i] = 1 ;
+                    continue ;
+                }
+                topology_.forEachSuccessor(i, [this, i](size_t s){ if ( live_[s] ) live_[i] = 1 ; });
+            }
+
+            changed = false ;
+            for ( const auto& e : feedback_ ){
+                size_t from = topology_.positionOf(e.from);
+                size_t to = topology_.positionOf(e.to);
+                if ( live_[to] && !live_[from] ){
+                    live_[from] = 1 ;
+                    changed = true ;
+                }
             }
         }
-        
-        result.push_back(module); // post-order traversal (only insert once all inputs are  visited)
+
+        for ( size_t i = 0 ; i < n ; ++i ){
+            if ( live_[i] ) topologicalOrder_.push_back(topology_.at(i));
+        }
     }
 
+    void reset(){
+        outputNodes_.clear();
+        topologicalOrder_.clear();
+        topology_.clear();
+        modulationEdges_.clear();
+        feedback_.clear();
+    }
 };
 
-#endif // __SIGNAL_CHAIN_HPP_
\ No newline at end of file
+#endif // __SIGNAL_CHAIN_HPP_
@@ -18,85 +18,700 @@
 #ifndef __SIGNAL_CONTROLLER_HPP_
 #define __SIGNAL_CONTROLLER_HPP_
 
+#include "containers/SnapshotExchange.hpp"
 #include "core/BaseModule.hpp"
 #include "core/ComponentManager.hpp"
+#include "diagnostics/Tracer.hpp"
+#include "meta/ComponentRegistry.hpp"
+#include "signal/ProcessingPlan.hpp"
 #include "signal/SignalChain.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json ;
+
 class SignalController {
+public:
+    /**
+     * @brief work the audio thread may leave out while the engine is overloaded
+     */
+    struct Quality {
+        size_t voiceLimit = 0 ;          // voices per polyphonic module, 0 for no limit
+        size_t controlInterval = 1 ;     // frames between updates of control rate modulation
+        size_t coefficientInterval = 1 ; // frames between filter coefficient updates
+        bool bypassOptional = false ;    // optional modules pass their inputs straight through
+    };
+
 private:
     ComponentManager* components_ ;
     SignalChain signalChain_ ;
 
+    // graph edits happen on API threads; the audio thread only sees published plans
+    std::recursive_mutex graphMutex_ ;
+    SnapshotExchange<ProcessingPlan> plans_ ;
+    int bulkDepth_ = 0 ;
+    bool dirty_ = false ;
+    bool lockBuffers_ = false ; // mlock each new plan's arena
+
+    const ProcessingPlan* active_ = nullptr ; // audio thread
+    size_t cursor_ = 0 ; // audio thread, frame index every processed module sits on
+    Quality quality_ ;   // audio thread
+    size_t controlPhase_ = 0 ; // audio thread, frames since the last control rate update
+    std::atomic<uint64_t> stolenVoices_{0} ;
+
 public:
     SignalController(ComponentManager* components):
         components_(components)
-    {}
+    {
+        plans_.publish(ProcessingPlan{});
+    }
+
+    /**
+     * @brief defers plan rebuilds until the outermost scope ends, so a batch of graph
+     * edits is computed and swapped in once
+     */
+    class BulkUpdate {
+    private:
+        SignalController& controller_ ;
+        std::lock_guard<std::recursive_mutex> lock_ ;
+
+    public:
+        BulkUpdate(SignalController& controller):
+            controller_(controller),
+            lock_(controller.graphMutex_)
+        {
+            controller_.bulkDepth_++ ;
+        }
+
+        ~BulkUpdate(){
+            if ( --controller_.bulkDepth_ == 0 && controller_.dirty_ ){
+                controller_.rebuild();
+            }
+        }
+
+        BulkUpdate(const BulkUpdate&) = delete ;
+        BulkUpdate& operator=(const BulkUpdate&) = delete ;
+    };
 
     // signal chain functions
-    void connect(BaseModule* from, size_t fromIndex, BaseModule* to, size_t toIndex){
-        if (!from) return ;
-        if (!to) return ;
-        to->connectInput(from,fromIndex, toIndex);
-        signalChain_.calculateTopologicalOrder();
+    bool connect(BaseModule* from, size_t fromIndex, BaseModule* to, size_t toIndex){
+        if (!from) return false ;
+        if (!to) return false ;
+        if ( fromIndex >= from->getNumOutputs() || toIndex >= to->getNumInputs() ) return false ;
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        if ( to->getInputs(toIndex).count({from, fromIndex}) ) return true ;
+
+        if ( signalChain_.addEdge(from, to) ){
+            to->connectInput(from, toIndex, fromIndex);
+        } else {
+            // closes a cycle: the consumer runs first and reads last frame's sample
+            SPDLOG_DEBUG("connection from component {} to {} closes a cycle, adding it as a feedback edge", from->getId(), to->getId());
+            signalChain_.addFeedback(from, fromIndex, to, toIndex);
+            to->connectInput(from, toIndex, fromIndex, true);
+        }
+        updateProcessingGraph();
+        return true ;
     }
 
     void disconnect(BaseModule* from, size_t fromIndex, BaseModule* to, size_t toIndex){
         if (!from) return ;
         if (!to) return ;
-        to->disconnectInput(from, fromIndex, toIndex);
-        signalChain_.calculateTopologicalOrder();
+        if ( fromIndex >= from->getNumOutputs() || toIndex >= to->getNumInputs() ) return ;
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        if ( !to->getInputs(toIndex).count({from, fromIndex}) ) return ;
+
+        to->disconnectInput(from, toIndex, fromIndex);
+        signalChain_.removeSignalEdge(from, fromIndex, to, toIndex);
+        updateProcessingGraph();
+    }
+
+    bool isFeedback(BaseModule* from, size_t fromIndex, BaseModule* to, size_t toIndex){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        return signalChain_.isFeedback(from, fromIndex, to, toIndex);
+    }
+
+    bool createsCycle(BaseModule* from, BaseModule* to){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        return signalChain_.createsCycle(from, to);
+    }
+
+    /**
+     * @brief update ordering after the module's modulation inputs changed
+     * 
+     * @return false if a new stateful modulator would create a cycle
+     */
+    bool updateModulation(BaseModule* target){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        bool ok = signalChain_.syncModulationEdges(target);
+        updateProcessingGraph();
+        return ok ;
+    }
+
+    // drop a module from the graph entirely, before it is deleted
+    void removeModule(BaseModule* module){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        signalChain_.removeModule(module);
+        updateProcessingGraph();
     }
 
     void registerSink(BaseModule* output, size_t index){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
         signalChain_.addSink(output, index);
-        signalChain_.calculateTopologicalOrder();
+        updateProcessingGraph();
     }
 
     void unregisterSink(BaseModule* output, size_t index){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
         signalChain_.removeSink(output, index);
-        signalChain_.calculateTopologicalOrder();
+        updateProcessingGraph();
     }
 
     const std::unordered_set<SignalConnection, ConnectionHash>& getSinks() const {
         return signalChain_.getSinks() ;
     }
 
-    double processFrame(){
-        auto chain = signalChain_.getModuleChain();
-        auto sinks = signalChain_.getSinks();
+    // lock the buffers of every plan built from now on
+    void setLockBuffers(bool enabled){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        lockBuffers_ = enabled ;
+    }
+
+    // generation of the most recently published plan
+    uint64_t getGeneration() const {
+        return plans_.generation() ;
+    }
+
+    // voices cut short to stay under Quality::voiceLimit
+    uint64_t getStolenVoices() const {
+        return stolenVoices_.load(std::memory_order_relaxed);
+    }
+
+    // the audio thread stopped, edits until it runs again keep only the latest plan
+    void detachAudio(){
+        plans_.detach();
+        active_ = nullptr ;
+    }
+
+    // ---------------- audio thread ----------------
+
+    // adopt the latest plan and clear generator buffers, once at the start of each block
+    void beginBlock(){
+        const ProcessingPlan* plan = plans_.acquire();
+        if ( plan != active_ ){
+            active_ = plan ;
+            adopt();
+        }
+        for ( BaseModule* m : active_->generative ){
+            m->clearBuffer();
+        }
+    }
+
+    /**
+     * @brief decide which steps can be skipped for the whole block
+     * 
+     * Runs after midi events are handled so generators know their voices. Steps are visited
+     * in order, so a module sees this block's decision for each of its inputs. Feedback inputs
+     * are read before their source decides, so they always count as sounding.
+     */
+    void prepareBlock(size_t nFrames){
+        for ( const auto& step : active_->steps ){
+            BaseModule* mod = step.module ;
+            if ( mod->isGenerative() ){
+                if ( quality_.voiceLimit > 0 && mod->isPolyphonic() ){
+                    size_t stolen = mod->stealVoices(quality_.voiceLimit);
+                    if ( stolen > 0 ) stolenVoices_.fetch_add(stolen, std::memory_order_relaxed);
+                }
+                setBypassed(step, mod->isSilent());
+                continue ;
+            }
 
+            bool folded = step.gainEnd > step.gainBegin ;
+            const BaseModule* head = folded ? active_->gains[step.gainBegin] : mod ;
+            setBypassed(step, mod->updateSilence(inputsSilent(head), folded ? 0 : mod->getTailFrames(), nFrames));
+        }
+    }
+
+    // advance parameter smoothing, and adopt collection snapshots, for every scheduled component
+    void prepareParameters(size_t nFrames, bool syncCollections){
+        for ( BaseComponent* c : active_->parameters ) c->prepareParameters(nFrames, syncCollections);
+    }
+
+    // the active plan's components by id, the audio thread's only way to look one up
+    const std::vector<BaseComponent*>& getComponentTable() const {
+        return active_->components ;
+    }
+
+    BaseComponent* resolve(ComponentId id) const {
+        const auto& table = active_->components ;
+        return id >= 0 && static_cast<size_t>(id) < table.size() ? table[id] : nullptr ;
+    }
+
+    // resolve the midi event queues of the active plan's handlers
+    void tickMidiHandlers(float dt){
+        for ( MidiEventHandler* h : active_->midiHandlers ) h->tick(dt);
+    }
+
+    // with Profile set, time spent on each step is added to its module's profile
+    template <bool Profile = false>
+    double processFrame(){
         double output = 0 ; 
-        for (BaseModule*  mod : chain){
-            mod->tick();
-            mod->calculateSample();
+        uint64_t t0 = Profile ? ModuleProfiler::ticks() : 0 ;
+        for ( const auto& step : active_->steps ){
+            BaseModule* mod = step.module ;
+            if ( mod->isBypassed() ) continue ;
+            if ( quality_.bypassOptional && step.gainBegin == step.gainEnd && mod->isOptional() ){
+                mod->passThrough();
+            } else if ( step.gainBegin == step.gainEnd ){
+                mod->tick();
+                mod->calculateSample();
+            } else {
+                mod->tick();
+                double gain = 1.0 ;
+                for ( uint32_t g = step.gainBegin ; g < step.gainEnd ; ++g ){
+                    gain *= active_->gains[g]->getGain() ;
+                }
+                mod->calculateFolded(*active_->gains[step.gainBegin], gain);
+            }
 
             // if an output index is a sink, add it to the final output
-            for ( size_t i = 0; i < mod->getNumOutputs(); ++i ){
-                if ( sinks.count({mod,i}) ){
-                    output += mod->getCurrentSample(i) ;
-                }
+            for ( uint32_t mask = step.sinkMask ; mask ; mask &= mask - 1 ){
+                output += mod->getCurrentSample(std::countr_zero(mask)) ;
+            }
+
+            if constexpr ( Profile ){
+                uint64_t t1 = ModuleProfiler::ticks();
+                mod->getProfile().processTicks += t1 - t0 ;
+                t0 = t1 ;
             }
         }
+        if ( ++cursor_ >= active_->frames ) cursor_ = 0 ;
 
         return output ;
     }
 
-    void clearBuffer(){
-        for ( auto id : components_->getModuleIds() ){
-            auto m = components_->getModule(id);
-            if ( m->isGenerative()){
-                m->clearBuffer();
+    /**
+     * @brief advance parameter smoothing and modulation for everything the plan still needs
+     * 
+     * Smoothing advances every frame. With a control interval above one, modulation is only
+     * recomputed every controlInterval frames, except on components modulated by a signal
+     * module, whose modulation keeps running at audio rate.
+     */
+    template <bool Profile = false>
+    void runParameterModulation(){
+        uint64_t t0 = Profile ? ModuleProfiler::ticks() : 0 ;
+        bool control = ++controlPhase_ >= quality_.controlInterval ;
+        if ( control ) controlPhase_ = 0 ;
+
+        const auto& parameters = active_->parameters ;
+        for ( size_t i = 0 ; i < parameters.size() ; ++i ){
+            BaseComponent* c = parameters[i] ;
+            c->updateParameters(control || i < active_->audioRateParameters);
+            if constexpr ( Profile ){
+                uint64_t t1 = ModuleProfiler::ticks();
+                c->getProfile().modulationTicks += t1 - t0 ;
+                t0 = t1 ;
             }
         }
     }
 
+    // switch to another quality, applied from the next frame on
+    void setQuality(const Quality& quality){
+        bool restore = quality_.bypassOptional && !quality.bypassOptional ;
+        quality_ = quality ;
+        controlPhase_ = 0 ;
+        if ( !active_ ) return ;
+        for ( const auto& step : active_->steps ){
+            step.module->setCoefficientInterval(quality_.coefficientInterval);
+            // state left over from before the module was passed through would sound stale
+            if ( restore && step.module->isOptional() ) step.module->resetTail();
+        }
+    }
+
+    // every component the active plan touches, a component may be visited more than once
+    template <typename F>
+    void forEachScheduled(F&& f){
+        for ( const auto& step : active_->steps ) f(step.module);
+        for ( BaseModule* gain : active_->gains ) f(gain);
+        for ( BaseComponent* c : active_->parameters ) f(c);
+    }
+
+    // ---------------- API threads ----------------
+
     void updateProcessingGraph(){
-        signalChain_.calculateTopologicalOrder();
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        if ( bulkDepth_ > 0 ){
+            dirty_ = true ;
+            return ;
+        }
+        rebuild();
+    }
+
+    // publish deferred edits now, even inside a BulkUpdate. Needed before modules are deleted
+    void flush(){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        if ( dirty_ ) rebuild();
     }
 
     void reset(){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
         signalChain_.reset() ;
+        rebuild();
+    }
+
+    // the latest published plan, by component id
+    json describePlan(){
+        std::lock_guard<std::recursive_mutex> lock(graphMutex_);
+        const ProcessingPlan* plan = plans_.latest() ;
+        json j ;
+        j["generation"] = plans_.generation() ;
+        j["steps"] = json::array();
+        j["parameters"] = json::array();
+        j["pruned"] = json::array();
+        j["elided"] = json::array();
+
+        std::unordered_set<BaseModule*> scheduled ;
+        for ( const auto& step : plan->steps ){
+            json s ;
+            s["componentId"] = step.module->getId() ;
+            s["sinks"] = json::array();
+            for ( uint32_t mask = step.sinkMask ; mask ; mask &= mask - 1 ){
+                s["sinks"].push_back(std::countr_zero(mask));
+            }
+            if ( step.gainEnd > step.gainBegin ){
+                s["folded"] = json::array();
+                for ( uint32_t g = step.gainBegin ; g < step.gainEnd ; ++g ){
+                    s["folded"].push_back(plan->gains[g]->getId());
+                    scheduled.insert(plan->gains[g]);
+                }
+            }
+            scheduled.insert(step.module);
+            j["steps"].push_back(s);
+        }
+
+        for ( BaseModule* m : plan->elided ){
+            j["elided"].push_back(m->getId());
+            scheduled.insert(m);
+        }
+
+        for ( BaseComponent* c : plan->parameters ){
+            j["parameters"].push_back(c->getId());
+        }
+
+        for ( ComponentId id : components_->getModuleIds() ){
+            BaseModule* m = components_->getModule(id);
+            if ( m && !scheduled.count(m) ) j["pruned"].push_back(id);
+        }
+
+        j["buffers"] = {
+            {"outputs", plan->slots.size()},
+            {"shared", plan->sharedOutputs},
+            {"slots", plan->arena ? plan->arena->size() : 0},
+            {"bytes", plan->arena ? plan->arena->bytes() : 0},
+            {"locked", plan->arena && plan->arena->isLocked()}
+        };
+
+        j["feedback"] = json::array();
+        signalChain_.forEachFeedback([&j](BaseModule* from, size_t fromIdx, BaseModule* to, size_t toIdx){
+            j["feedback"].push_back({
+                {"from", from->getId()}, {"fromIndex", fromIdx},
+                {"to", to->getId()}, {"toIndex", toIdx}
+            });
+        });
+        return j ;
+    }
+
+private:
+    void rebuild(){
+        TRACE_SCOPE("graph_rebuild");
+        dirty_ = false ;
+        signalChain_.calculateTopologicalOrder();
+
+        ProcessingPlan plan ;
+        const auto& sinks = signalChain_.getSinks();
+        const auto& order = signalChain_.getModuleChain() ;
+
+        std::unordered_map<BaseModule*, size_t> position ;
+        for ( size_t i = 0 ; i < order.size() ; ++i ) position[order[i]] = i ;
+
+        // elision: a stateless module whose inputs are unconnected or elided themselves can
+        // only output silence. Decided in processing order, so silent chains go as a whole.
+        std::vector<char> elided(order.size(), 0);
+        std::vector<BaseModule*> live ;
+        for ( size_t i = 0 ; i < order.size() ; ++i ){
+            elided[i] = isSilentStage(order[i], position, elided);
+            if ( !elided[i] ) live.push_back(order[i]);
+        }
+
+        // gain folding: a gain stage whose only input is another gain stage feeding nothing
+        // else absorbs it. The absorbed stage's step is dropped and its chain moves along.
+        // A unit gain standing on its own is still processed, its scalar may change at any time.
+        std::vector<std::vector<BaseModule*>> chains(order.size());
+        std::vector<char> absorbed(order.size(), 0);
+
+        for ( size_t i = 0 ; i < order.size() ; ++i ){
+            BaseModule* mod = order[i] ;
+            if ( elided[i] || !mod->isGainStage() ) continue ;
+            chains[i].push_back(mod);
+
+            const auto& inputs = mod->getInputs(0);
+            if ( inputs.size() != 1 ) continue ;
+            const SignalConnection& in = *inputs.begin() ;
+            auto it = position.find(in.module);
+            if ( in.feedback || it == position.end() || !canFold(in.module, sinks) ) continue ;
+
+            size_t p = it->second ;
+            chains[i].insert(chains[i].begin(), chains[p].begin(), chains[p].end());
+            absorbed[p] = 1 ;
+        }
+
+        for ( size_t i = 0 ; i < order.size() ; ++i ){
+            BaseModule* mod = order[i] ;
+            if ( mod->isGenerative() ) plan.generative.push_back(mod);
+            if ( elided[i] ) plan.elided.push_back(mod);
+            if ( absorbed[i] || elided[i] ) continue ;
+
+            uint32_t mask = 0 ;
+            for ( size_t o = 0 ; o < mod->getNumOutputs() && o < 32 ; ++o ){
+                if ( sinks.count({mod, o}) ) mask |= uint32_t{1} << o ;
+            }
+
+            ProcessingPlan::Step step{mod, mask};
+            if ( chains[i].size() > 1 ){
+                step.gainBegin = plan.gains.size() ;
+                plan.gains.insert(plan.gains.end(), chains[i].begin(), chains[i].end());
+                step.gainEnd = plan.gains.size() ;
+            }
+            plan.steps.push_back(step);
+        }
+
+        plan.parameters = parameterSchedule(live);
+        // components modulated at audio rate go first, they never drop to the control rate
+        auto controlRate = std::stable_partition(plan.parameters.begin(), plan.parameters.end(), hasSignalModulator);
+        plan.audioRateParameters = controlRate - plan.parameters.begin() ;
+        if ( components_ ){
+            plan.components.assign(components_->getNextId(), nullptr);
+            components_->forEach([&plan](BaseComponent* c){ plan.components[c->getId()] = c ; });
+            for ( ComponentId id : components_->getMidiHandlerIds() ) plan.midiHandlers.push_back(components_->getMidiHandler(id));
+        }
+        allocateBuffers(plan);
+        plans_.publish(std::move(plan));
+    }
+
+    /**
+     * @brief place every step's outputs in the arena
+     * 
+     * An output read only by later steps in the same frame is free once its last reader has
+     * run, and the slot goes back to the pool. Outputs read at any other time keep a slot of
+     * their own: sinks, generators, feedback sources, stateful modulators and metered modules.
+     */
+    void allocateBuffers(ProcessingPlan& plan){
+        const auto& sinks = signalChain_.getSinks();
+        size_t nSteps = plan.steps.size();
+
+        std::unordered_set<const BaseModule*> silent(plan.elided.begin(), plan.elided.end());
+        std::unordered_map<const BaseModule*, size_t> stepOf ;
+        for ( size_t s = 0 ; s < nSteps ; ++s ){
+            stepOf[plan.steps[s].module] = s ;
+            for ( uint32_t g = plan.steps[s].gainBegin ; g < plan.steps[s].gainEnd ; ++g ){
+                stepOf[plan.gains[g]] = s ;
+            }
+        }
+
+        std::vector<size_t> slotOf ;
+        std::vector<std::vector<size_t>> expiring(nSteps + 1);
+        std::vector<size_t> freeSlots ;
+        size_t nSlots = 0 ;
+        size_t maxOutputs = 1 ;
+        plan.frames = 1 ;
+        for ( const BaseModule* mod : plan.elided ) maxOutputs = std::max(maxOutputs, mod->getNumOutputs());
+
+        for ( size_t s = 0 ; s < nSteps ; ++s ){
+            // slots whose last reader ran before this step
+            freeSlots.insert(freeSlots.end(), expiring[s].begin(), expiring[s].end());
+
+            auto& step = plan.steps[s] ;
+            BaseModule* mod = step.module ;
+            plan.frames = std::max(plan.frames, mod->size());
+            maxOutputs = std::max(maxOutputs, mod->getNumOutputs());
+            step.slots = slotOf.size() ;
+
+            bool pinned = mod->isGenerative() || mod->isObserved() ||
+                signalChain_.isFeedbackSource(mod) || signalChain_.isModulationSource(mod) ;
+
+            for ( size_t o = 0 ; o < mod->getNumOutputs() ; ++o ){
+                size_t lastRead = s ;
+                for ( const auto& conn : mod->getOutputs(o) ){
+                    auto it = stepOf.find(conn.module);
+                    if ( it != stepOf.end() ) lastRead = std::max(lastRead, it->second);
+                }
+
+                if ( pinned || sinks.count({mod, o}) ){
+                    slotOf.push_back(nSlots++);
+                } else if ( !freeSlots.empty() ){
+                    slotOf.push_back(freeSlots.back());
+                    freeSlots.pop_back();
+                    expiring[lastRead + 1].push_back(slotOf.back());
+                    plan.sharedOutputs++ ;
+                } else {
+                    slotOf.push_back(nSlots++);
+                    expiring[lastRead + 1].push_back(slotOf.back());
+                }
+            }
+        }
+
+        plan.arena = std::make_unique<BufferArena>(nSlots, plan.frames);
+        if ( lockBuffers_ ) plan.arena->lock();
+        for ( size_t slot : slotOf ) plan.slots.push_back(plan.arena->slot(slot));
+        plan.zeros.assign(maxOutputs, plan.arena->zeros());
+
+        for ( const auto& step : plan.steps ){
+            plan.bindings.push_back({step.module, step.slots, planInputs(plan, step.module, silent)});
+        }
+        for ( BaseModule* mod : plan.elided ){
+            plan.bindings.push_back({mod, ProcessingPlan::SILENT});
+        }
+        // everything else writes to its own storage, in case an older arena still holds it
+        if ( components_ ){
+            for ( ComponentId id : components_->getModuleIds() ){
+                BaseModule* m = components_->getModule(id);
+                if ( m && !stepOf.count(m) && !silent.count(m) ) plan.bindings.push_back({m, ProcessingPlan::OWN_STORAGE});
+            }
+            for ( const auto& step : plan.steps ){
+                for ( uint32_t g = step.gainBegin ; g + 1 < step.gainEnd ; ++g ){
+                    // the head of a folded chain is still read by its step
+                    uint32_t inputs = g == step.gainBegin ? planInputs(plan, plan.gains[g], silent) : ProcessingPlan::NO_INPUTS ;
+                    plan.bindings.push_back({plan.gains[g], ProcessingPlan::OWN_STORAGE, inputs});
+                }
+            }
+        }
+    }
+
+    // copy a module's connections into the plan, returns its first entry in inputBounds. Elided sources are left out
+    static uint32_t planInputs(ProcessingPlan& plan, const BaseModule* mod, const std::unordered_set<const BaseModule*>& silent){
+        uint32_t first = plan.inputBounds.size();
+        for ( size_t i = 0 ; i < mod->getNumInputs() ; ++i ){
+            plan.inputBounds.push_back(plan.inputs.size());
+            for ( const auto& conn : mod->getInputs(i) ){
+                if ( !silent.count(conn.module) ) plan.inputs.push_back({conn.module, conn.index, conn.feedback});
+            }
+        }
+        plan.inputBounds.push_back(plan.inputs.size());
+        return first ;
+    }
+
+    // audio thread: move every module onto the new plan's buffers
+    void adopt(){
+        if ( cursor_ >= active_->frames ) cursor_ = 0 ;
+        for ( const auto& step : active_->steps ){
+            step.module->setCoefficientInterval(quality_.coefficientInterval);
+        }
+        for ( const auto& b : active_->bindings ){
+            if ( b.inputs == ProcessingPlan::NO_INPUTS ){
+                b.module->bindInputs(nullptr, nullptr);
+            } else {
+                b.module->bindInputs(active_->inputs.data(), &active_->inputBounds[b.inputs]);
+            }
+            if ( b.slots == ProcessingPlan::OWN_STORAGE ){
+                b.module->bindOutputs(nullptr, cursor_);
+            } else if ( b.slots == ProcessingPlan::SILENT || b.module->isBypassed() ){
+                b.module->bindOutputs(active_->zeros.data(), cursor_, false);
+            } else {
+                b.module->bindOutputs(&active_->slots[b.slots], cursor_);
+            }
+        }
+    }
+
+    // audio thread: a skipped module reads as silence, since its slot may be reused meanwhile
+    void setBypassed(const ProcessingPlan::Step& step, bool bypass){
+        BaseModule* mod = step.module ;
+        if ( bypass == mod->isBypassed() ) return ;
+        mod->setBypassed(bypass);
+        if ( bypass ){
+            mod->bindOutputs(active_->zeros.data(), cursor_, false);
+        } else {
+            mod->bindOutputs(&active_->slots[step.slots], cursor_, false);
+        }
+    }
+
+    static bool inputsSilent(const BaseModule* mod){
+        for ( const PlannedInput& in : mod->getPlannedInputs() ){
+            if ( in.feedback || !in.module->isBypassed() ) return false ;
+        }
+        return true ;
+    }
+
+    // a modulator that is also a module produces a new value every frame
+    static bool hasSignalModulator(const BaseComponent* c){
+        for ( ParameterType p : ComponentRegistry::getComponentDescriptor(c->getType()).modulatableParameters ){
+            if ( dynamic_cast<BaseModule*>(c->getParameterModulator(p)) ) return true ;
+            if ( dynamic_cast<BaseModule*>(c->getParameterDepthModulator(p)) ) return true ;
+        }
+        return false ;
+    }
+
+    // a module without state, fed nothing that can sound
+    bool isSilentStage(BaseModule* mod, const std::unordered_map<BaseModule*, size_t>& position, const std::vector<char>& elided) const {
+        if ( mod->isGenerative() || mod->getTailFrames() != 0 ) return false ;
+        if ( signalChain_.isModulationSource(mod) ) return false ;
+        for ( size_t i = 0 ; i < mod->getNumInputs() ; ++i ){
+            for ( const auto& conn : mod->getInputs(i) ){
+                auto it = position.find(conn.module);
+                if ( conn.feedback || it == position.end() || !elided[it->second] ) return false ;
+            }
+        }
+        return true ;
+    }
+
+    // a gain stage that can disappear into its only consumer
+    static bool canFold(BaseModule* mod, const std::unordered_set<SignalConnection, ConnectionHash>& sinks){
+        if ( !mod->isGainStage() || mod->getNumOutputs() != 1 ) return false ;
+        if ( sinks.count({mod, 0}) ) return false ;
+        if ( mod->getOutputs(0).size() != 1 ) return false ;
+        if ( dynamic_cast<BaseModulator*>(mod) ) return false ;
+        // its inputs would be read later than planned, which changes what a feedback edge delivers
+        for ( const auto& conn : mod->getInputs(0) ){
+            if ( conn.feedback ) return false ;
+        }
+        return true ;
+    }
+
+    /**
+     * @brief components whose parameters still matter
+     * 
+     * Every live module, every modulator reachable from one through its parameter
+     * modulations, and the components outside the signal graph (midi handlers).
+     * Modules that were pruned, and the modulators only they used, are skipped.
+     */
+    std::vector<BaseComponent*> parameterSchedule(const std::vector<BaseModule*>& order){
+        std::vector<BaseComponent*> pending(order.begin(), order.end());
+        if ( components_ ){
+            components_->forEach([&pending](BaseComponent* c){
+                if ( !dynamic_cast<BaseModule*>(c) && !dynamic_cast<BaseModulator*>(c) ) pending.push_back(c);
+            });
+        }
+
+        std::vector<BaseComponent*> schedule ;
+        std::unordered_set<BaseComponent*> seen ;
+        while ( !pending.empty() ){
+            BaseComponent* c = pending.back() ;
+            pending.pop_back();
+            if ( !seen.insert(c).second ) continue ;
+            schedule.push_back(c);
+
+            for ( ParameterType p : ComponentRegistry::getComponentDescriptor(c->getType()).modulatableParameters ){
+                if ( BaseModulator* m = c->getParameterModulator(p) ) pending.push_back(m);
+                if ( BaseModulator* m = c->getParameterDepthModulator(p) ) pending.push_back(m);
+            }
+        }
+        return schedule ;
     }
 };
 
-#endif // __SIGNAL_CONTROLLER_HPP_
\ No newline at end of file
+#endif // __SIGNAL_CONTROLLER_HPP_